@@ -0,0 +1,94 @@
+/*
+ * dish_aggregate_bench.c
+ *
+ * Builds pairs of large dishes, from 1250 up to 20000 parve ingredients, then
+ * times rejecting a milky ingredient once the last one is meaty, removing and
+ * re-adding an ingredient, and comparing the two dishes with dishGetQuality and
+ * dishIsBetter. Times are per operation.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/dish_aggregate_bench.c $(ls *.c | grep -v _test.c) \
+ *       -o dish_aggregate_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "dish.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MIN_SIZE 1250
+#define MAX_SIZE 20000
+#define OPERATIONS 2000
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static Ingredient makeIngredient(int i, KosherType kosherType) {
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	sprintf(name, "Ingredient %d", i);
+	return ingredientInitialize(name, kosherType,
+						i % (INGREDIENT_MAX_CALORIES + 1),
+						i % (INGREDIENT_MAX_HEALTH + 1), (i % 100) * 0.25, NULL);
+}
+
+static Dish buildDish(Ingredient* ingredients, int size) {
+	Dish dish = dishCreate("Dish", "Cook", size + 1);
+	for (int i = 0; i < size; i++) {
+		dishAddIngredient(dish, ingredients[i]);
+	}
+	return dish;
+}
+
+int main() {
+	Ingredient* ingredients = malloc(sizeof(Ingredient) * MAX_SIZE);
+	if (ingredients == NULL) {
+		return 1;
+	}
+	for (int i = 0; i < MAX_SIZE; i++) {
+		ingredients[i] = makeIngredient(i, PARVE);
+	}
+	Ingredient meaty = makeIngredient(MAX_SIZE, MEATY);
+	Ingredient milky = makeIngredient(MAX_SIZE + 1, MILKY);
+	double sum = 0;
+	printf("%6s %12s %12s %12s %12s\n", "size", "build ms", "reject ns",
+			"swap ns", "compare ns");
+	for (int size = MIN_SIZE; size <= MAX_SIZE; size *= 2) {
+		double start = now();
+		Dish first = buildDish(ingredients, size);
+		Dish second = buildDish(ingredients, size);
+		double build = (now() - start) / 2;
+		dishRemoveIngredient(first, size - 1);
+		dishAddIngredient(first, meaty);
+		start = now();
+		for (int i = 0; i < OPERATIONS; i++) {
+			sum += dishAddIngredient(first, milky);
+		}
+		double reject = (now() - start) / OPERATIONS;
+		dishRemoveIngredient(first, size - 1);
+		start = now();
+		for (int i = 0; i < OPERATIONS; i++) {
+			dishAddIngredient(first, ingredients[size - 1]);
+			dishRemoveIngredient(first, size - 1);
+		}
+		double swap = (now() - start) / OPERATIONS;
+		start = now();
+		for (int i = 0; i < OPERATIONS; i++) {
+			double quality;
+			bool isBetter;
+			dishGetQuality(first, &quality);
+			dishIsBetter(first, second, 0.5, &isBetter);
+			sum += quality + isBetter;
+		}
+		double compare = (now() - start) / OPERATIONS;
+		printf("%6d %12.2f %12.1f %12.1f %12.1f\n", size, build * 1e3,
+				reject * 1e9, swap * 1e9, compare * 1e9);
+		dishDestroy(first);
+		dishDestroy(second);
+	}
+	printf("(checksum %g)\n", sum);
+	free(ingredients);
+	return 0;
+}
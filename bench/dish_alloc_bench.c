@@ -0,0 +1,102 @@
+/*
+ * dish_alloc_bench.c
+ *
+ * Counts the heap allocations made while building dishes, and times building
+ * them, reading their quality and destroying them, for a range of dish sizes.
+ * malloc, calloc and realloc are wrapped by the linker, so every call the
+ * library makes is counted.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/dish_alloc_bench.c $(ls *.c | grep -v _test.c) \
+ *       -o dish_alloc_bench -lm -pthread \
+ *       -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "dish.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TOTAL_INGREDIENTS (1 << 21)
+#define MAX_SIZE 256
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+static long long allocations = 0;
+
+void* __wrap_malloc(size_t size) {
+	allocations++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+	allocations++;
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+	allocations++;
+	return __real_realloc(pointer, size);
+}
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static Ingredient ingredients[MAX_SIZE];
+
+static void fillIngredients() {
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	for (int i = 0; i < MAX_SIZE; i++) {
+		sprintf(name, "Ingredient %d", i);
+		ingredients[i] = ingredientInitialize(name, PARVE,
+						i % (INGREDIENT_MAX_CALORIES + 1),
+						i % (INGREDIENT_MAX_HEALTH + 1), i * 0.25, NULL);
+	}
+}
+
+int main() {
+	fillIngredients();
+	Dish* dishes = malloc(sizeof(Dish) * TOTAL_INGREDIENTS);
+	if (dishes == NULL) {
+		return 1;
+	}
+	double sum = 0;
+	printf("%5s %8s %12s %12s %12s %12s\n", "size", "dishes",
+			"allocs/dish", "build ns", "quality ns", "destroy ns");
+	for (int size = 1; size <= MAX_SIZE; size *= 4) {
+		int count = TOTAL_INGREDIENTS / size;
+		long long before = allocations;
+		double start = now();
+		for (int d = 0; d < count; d++) {
+			dishes[d] = dishCreate("Dish", "Cook", size);
+			for (int i = 0; i < size; i++) {
+				dishAddIngredient(dishes[d], ingredients[i]);
+			}
+		}
+		double build = now() - start;
+		long long made = allocations - before;
+		start = now();
+		for (int d = 0; d < count; d++) {
+			double quality;
+			dishGetQuality(dishes[d], &quality);
+			sum += quality;
+		}
+		double quality = now() - start;
+		start = now();
+		for (int d = 0; d < count; d++) {
+			dishDestroy(dishes[d]);
+		}
+		double destroy = now() - start;
+		printf("%5d %8d %12.2f %12.1f %12.1f %12.1f\n", size, count,
+				(double)made / count, build / count * 1e9,
+				quality / count * 1e9, destroy / count * 1e9);
+	}
+	printf("(checksum %g)\n", sum);
+	free(dishes);
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * dish_duplicates_bench.c
+ *
+ * Times dishAreDuplicateIngredients on dishes of 10 up to 100000 ingredients
+ * with distinct names, which is the worst case for the query since no early
+ * match can end it. Each size repeats the query for at least MIN_SECONDS,
+ * running it at least once, and reports the mean time per query.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/dish_duplicates_bench.c $(ls *.c | grep -v _test.c) \
+ *       -o dish_duplicates_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "dish.h"
+#include <stdio.h>
+#include <time.h>
+
+#define MIN_SIZE 10
+#define MAX_SIZE 100000
+#define MIN_SECONDS 0.5
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static Dish buildDish(int size) {
+	Dish dish = dishCreate("Dish", "Cook", size);
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	for (int i = 0; i < size; i++) {
+		sprintf(name, "Ingredient %d", i);
+		dishAddIngredient(dish, ingredientInitialize(name, PARVE,
+						i % (INGREDIENT_MAX_CALORIES + 1),
+						i % (INGREDIENT_MAX_HEALTH + 1), 1, NULL));
+	}
+	return dish;
+}
+
+int main() {
+	int found = 0;
+	printf("%7s %8s %14s %14s\n", "size", "queries", "query us",
+			"ns/ingredient");
+	for (int size = MIN_SIZE; size <= MAX_SIZE; size *= 10) {
+		Dish dish = buildDish(size);
+		int queries = 0;
+		double start = now();
+		double elapsed;
+		do {
+			bool areDuplicate;
+			dishAreDuplicateIngredients(dish, &areDuplicate);
+			found += areDuplicate;
+			queries++;
+			elapsed = now() - start;
+		} while (elapsed < MIN_SECONDS);
+		double query = elapsed / queries;
+		printf("%7d %8d %14.2f %14.2f\n", size, queries, query * 1e6,
+				query / size * 1e9);
+		dishDestroy(dish);
+	}
+	printf("(%d duplicates found)\n", found);
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * dish_tasting_bench.c
+ *
+ * Measures dishTaste throughput on one DISH_CONCURRENT_TASTING dish as the
+ * number of tasting threads grows. Each thread count performs the same total
+ * number of tastings, so a scaling build shows a shorter time per run.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/dish_tasting_bench.c $(ls *.c | grep -v _test.c) \
+ *       -o dish_tasting_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "dish.h"
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#define TOTAL_TASTINGS 40000000
+#define MAX_THREADS 8
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+typedef struct {
+	Dish dish;
+	int tastings;
+} Judge;
+
+static void* tasteMany(void* context) {
+	Judge* judge = (Judge*)context;
+	for (int i = 0; i < judge->tastings; i++) {
+		dishTaste(judge->dish, i % 4 == 0);
+	}
+	return NULL;
+}
+
+static double timeTastings(Dish dish, int threads) {
+	pthread_t ids[MAX_THREADS];
+	Judge judges[MAX_THREADS];
+	double start = now();
+	for (int i = 0; i < threads; i++) {
+		judges[i].dish = dish;
+		judges[i].tastings = TOTAL_TASTINGS / threads;
+		pthread_create(&ids[i], NULL, tasteMany, &judges[i]);
+	}
+	for (int i = 0; i < threads; i++) {
+		pthread_join(ids[i], NULL);
+	}
+	return now() - start;
+}
+
+int main() {
+	Dish plain = dishCreate("Sir Shel Osher", "Kulam", 1);
+	Judge judge = { plain, TOTAL_TASTINGS };
+	double start = now();
+	tasteMany(&judge);
+	double seconds = now() - start;
+	printf("%-24s %8.3f s %10.1f M tastings/s\n", "plain, 1 thread",
+			seconds, TOTAL_TASTINGS / seconds / 1e6);
+	dishDestroy(plain);
+
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		Dish dish = dishCreateWithFlags("Sir Shel Osher", "Kulam", 1,
+										DISH_CONCURRENT_TASTING);
+		seconds = timeTastings(dish, threads);
+		char label[32];
+		sprintf(label, "concurrent, %d thread%s", threads,
+				threads == 1 ? "" : "s");
+		printf("%-24s %8.3f s %10.1f M tastings/s\n", label, seconds,
+				TOTAL_TASTINGS / seconds / 1e6);
+		dishDestroy(dish);
+	}
+	return 0;
+}
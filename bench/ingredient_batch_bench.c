@@ -0,0 +1,135 @@
+/*
+ * ingredient_batch_bench.c
+ *
+ * Compares ingredientInitializeBatch with a loop of ingredientInitialize
+ * calls over the same columns, for a range of batch sizes. Every size
+ * initializes the same total number of ingredients. Then times
+ * ingredientInitializeBatchParallel on one large batch with 1 to MAX_THREADS
+ * threads.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/ingredient_batch_bench.c \
+ *       $(ls *.c | grep -v _test.c) -o ingredient_batch_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "ingredient.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TOTAL_ROWS (1 << 23)
+#define MAX_BATCH 4096
+#define DISTINCT_NAMES 64
+#define PARALLEL_ROWS (1 << 20)
+#define PARALLEL_RUNS 8
+#define MAX_THREADS 8
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static const char* names[MAX_BATCH];
+static KosherType kosherTypes[MAX_BATCH];
+static int calories[MAX_BATCH];
+static int health[MAX_BATCH];
+static double costs[MAX_BATCH];
+static Ingredient ingredients[MAX_BATCH];
+static IngredientResult results[MAX_BATCH];
+
+static void fillColumns() {
+	static char storage[DISTINCT_NAMES][16];
+	for (int i = 0; i < DISTINCT_NAMES; i++) {
+		sprintf(storage[i], "Ingredient %d", i);
+	}
+	for (int i = 0; i < MAX_BATCH; i++) {
+		names[i] = storage[i % DISTINCT_NAMES];
+		kosherTypes[i] = (KosherType)(i % INGREDIENT_KOSHER_TYPE_VALUES);
+		calories[i] = (i * 37) % (INGREDIENT_MAX_CALORIES + 1);
+		health[i] = (i * 7) % (INGREDIENT_MAX_HEALTH + 1);
+		costs[i] = (i % 100) * 0.25;
+	}
+}
+
+/* Keeps the compiler from dropping the work being timed. */
+static double checksum() {
+	double sum = 0;
+	for (int i = 0; i < MAX_BATCH; i++) {
+		sum += ingredients[i].calories + results[i];
+	}
+	return sum;
+}
+
+static double timeLoop(int batch) {
+	double start = now();
+	for (int done = 0; done < TOTAL_ROWS; done += batch) {
+		for (int i = 0; i < batch; i++) {
+			ingredients[i] = ingredientInitialize(names[i], kosherTypes[i],
+									calories[i], health[i], costs[i], results+i);
+		}
+	}
+	return now() - start;
+}
+
+static double timeBatch(int batch) {
+	double start = now();
+	for (int done = 0; done < TOTAL_ROWS; done += batch) {
+		ingredientInitializeBatch(names, kosherTypes, calories, health, costs,
+									batch, ingredients, results);
+	}
+	return now() - start;
+}
+
+/* Repeats the columns over PARALLEL_ROWS rows and times one large batch. */
+static double timeParallel(int threads, double* sum) {
+	static const char* bigNames[PARALLEL_ROWS];
+	static KosherType bigKosherTypes[PARALLEL_ROWS];
+	static int bigCalories[PARALLEL_ROWS];
+	static int bigHealth[PARALLEL_ROWS];
+	static double bigCosts[PARALLEL_ROWS];
+	static Ingredient bigIngredients[PARALLEL_ROWS];
+	static IngredientResult bigResults[PARALLEL_ROWS];
+	for (int i = 0; i < PARALLEL_ROWS; i++) {
+		bigNames[i] = names[i % MAX_BATCH];
+		bigKosherTypes[i] = kosherTypes[i % MAX_BATCH];
+		bigCalories[i] = calories[i % MAX_BATCH];
+		bigHealth[i] = health[i % MAX_BATCH];
+		bigCosts[i] = costs[i % MAX_BATCH];
+	}
+	double start = now();
+	for (int run = 0; run < PARALLEL_RUNS; run++) {
+		ingredientInitializeBatchParallel(bigNames, bigKosherTypes,
+				bigCalories, bigHealth, bigCosts, PARALLEL_ROWS, threads,
+				bigIngredients, bigResults);
+	}
+	double elapsed = now() - start;
+	for (int i = 0; i < PARALLEL_ROWS; i += MAX_BATCH) {
+		*sum += bigIngredients[i].calories + bigResults[i];
+	}
+	return elapsed;
+}
+
+int main() {
+	fillColumns();
+	double sum = 0;
+	printf("%6s %10s %10s %8s\n", "batch", "loop ns", "batch ns", "speedup");
+	for (int batch = 1; batch <= MAX_BATCH; batch *= 8) {
+		double loop = timeLoop(batch);
+		sum += checksum();
+		double batched = timeBatch(batch);
+		sum += checksum();
+		printf("%6d %10.1f %10.1f %7.2fx\n", batch, loop / TOTAL_ROWS * 1e9,
+				batched / TOTAL_ROWS * 1e9, loop / batched);
+	}
+	printf("\n%7s %10s %8s\n", "threads", "ns/row", "speedup");
+	double single = 0;
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		double elapsed = timeParallel(threads, &sum);
+		single = (threads == 1) ? elapsed : single;
+		printf("%7d %10.1f %7.2fx\n", threads,
+				elapsed / PARALLEL_ROWS / PARALLEL_RUNS * 1e9, single / elapsed);
+	}
+	printf("(checksum %g)\n", sum);
+	return 0;
+}
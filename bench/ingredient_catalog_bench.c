@@ -0,0 +1,126 @@
+/*
+ * ingredient_catalog_bench.c
+ *
+ * Compares the startup cost of loading ingredients from a CSV file with
+ * ingredient_reader against opening the same ingredients as a binary catalog.
+ * Both files are written to the current directory first, and removed at the
+ * end. Run it twice to time a warm page cache for both formats.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/ingredient_catalog_bench.c \
+ *       $(ls *.c | grep -v _test.c) -o ingredient_catalog_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "ingredient_catalog.h"
+#include "ingredient_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ROWS 1000000
+#define CSV_FILE "ingredient_catalog_bench.csv"
+#define CATALOG_FILE "ingredient_catalog_bench.cat"
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static bool writeFiles() {
+	FILE* csv = fopen(CSV_FILE, "wb");
+	Ingredient* ingredients = malloc(sizeof(Ingredient) * ROWS);
+	if (csv == NULL || ingredients == NULL) {
+		return false;
+	}
+	for (int row = 0; row < ROWS; row++) {
+		char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+		sprintf(name, "Ingredient %d", row % 1000);
+		int calories = row % (INGREDIENT_MAX_CALORIES + 1);
+		int health = row % (INGREDIENT_MAX_HEALTH + 1);
+		double cost = (row % 100) + 0.25;
+		KosherType kosherType = row % 3 == 0 ? MEATY : PARVE;
+		fprintf(csv, "%s,%s,%d,%d,%.2f\n", name,
+				kosherType == MEATY ? "MEATY" : "PARVE", calories, health, cost);
+		ingredients[row] = ingredientInitialize(name, kosherType, calories,
+												health, cost, NULL);
+	}
+	fclose(csv);
+	bool written = ingredientCatalogWrite(CATALOG_FILE, ingredients, ROWS) ==
+												INGREDIENT_CATALOG_SUCCESS;
+	free(ingredients);
+	return written;
+}
+
+/* Parses every row into an ingredient, summing calories to use them. */
+static double timeCsv(long long* sum) {
+	double start = now();
+	FILE* file = fopen(CSV_FILE, "rb");
+	IngredientReader reader = ingredientReaderCreateFromFile(file);
+	Ingredient ingredient;
+	IngredientResult result;
+	while (ingredientReaderNext(reader, &ingredient, &result) !=
+			INGREDIENT_READER_END_OF_INPUT) {
+		*sum += ingredient.calories;
+	}
+	ingredientReaderDestroy(reader);
+	fclose(file);
+	return now() - start;
+}
+
+static double timeOpen() {
+	double start = now();
+	IngredientCatalog catalog;
+	ingredientCatalogOpen(CATALOG_FILE, &catalog);
+	double seconds = now() - start;
+	ingredientCatalogClose(catalog);
+	return seconds;
+}
+
+static double timeOpenVerify() {
+	double start = now();
+	IngredientCatalog catalog;
+	ingredientCatalogOpen(CATALOG_FILE, &catalog);
+	ingredientCatalogVerify(catalog);
+	double seconds = now() - start;
+	ingredientCatalogClose(catalog);
+	return seconds;
+}
+
+/* Opens the catalog and reads every record, as the CSV timing does. */
+static double timeOpenRead(long long* sum) {
+	double start = now();
+	IngredientCatalog catalog;
+	ingredientCatalogOpen(CATALOG_FILE, &catalog);
+	int size = ingredientCatalogSize(catalog);
+	for (int i = 0; i < size; i++) {
+		ValidIngredient ingredient;
+		ingredientCatalogGet(catalog, i, &ingredient);
+		*sum += ingredient.ingredient.calories;
+	}
+	double seconds = now() - start;
+	ingredientCatalogClose(catalog);
+	return seconds;
+}
+
+int main() {
+	if (!writeFiles()) {
+		printf("Couldn't write the benchmark files\n");
+		return 1;
+	}
+	long long csvSum = 0;
+	long long catalogSum = 0;
+	double csv = timeCsv(&csvSum);
+	double open = timeOpen();
+	double verify = timeOpenVerify();
+	double read = timeOpenRead(&catalogSum);
+	printf("%d ingredients\n", ROWS);
+	printf("%-28s %10.3f ms\n", "CSV parse", csv * 1e3);
+	printf("%-28s %10.3f ms\n", "catalog open", open * 1e3);
+	printf("%-28s %10.3f ms\n", "catalog open + verify", verify * 1e3);
+	printf("%-28s %10.3f ms\n", "catalog open + get every row", read * 1e3);
+	printf("(sums %s)\n", csvSum == catalogSum ? "match" : "differ");
+	remove(CSV_FILE);
+	remove(CATALOG_FILE);
+	return 0;
+}
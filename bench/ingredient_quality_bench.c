@@ -0,0 +1,87 @@
+/*
+ * ingredient_quality_bench.c
+ *
+ * Times ingredientGetQuality over a million ingredients with random calories
+ * and health, against the quality formula evaluated inline the way
+ * ingredientGetQuality did before the quality table. Both loops run several
+ * times over the same ingredients and report the best time per call.
+ *
+ * Build from the repository root:
+ *   gcc -std=c99 -O2 -I. bench/ingredient_quality_bench.c $(ls *.c | grep -v _test.c) \
+ *       -o ingredient_quality_bench -lm -pthread
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "ingredient.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define INGREDIENTS 1000000
+#define RUNS 10
+
+static double now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static double arithmeticQuality(Ingredient ingredient) {
+	double calorieRange = INGREDIENT_MAX_CALORIES - INGREDIENT_MIN_CALORIES;
+	double healthRange = INGREDIENT_MAX_HEALTH - INGREDIENT_MIN_HEALTH;
+	double quality = ingredient.health * (10.0 / healthRange) -
+					ingredient.calories * (10.0 / calorieRange);
+	return quality > 0 ? quality : 0;
+}
+
+static double timeTable(const Ingredient* ingredients, double* sum) {
+	double best = 0;
+	for (int run = 0; run < RUNS; run++) {
+		double total = 0;
+		double start = now();
+		for (int i = 0; i < INGREDIENTS; i++) {
+			total += ingredientGetQuality(ingredients[i]);
+		}
+		double elapsed = now() - start;
+		*sum += total;
+		best = (run == 0 || elapsed < best) ? elapsed : best;
+	}
+	return best;
+}
+
+static double timeArithmetic(const Ingredient* ingredients, double* sum) {
+	double best = 0;
+	for (int run = 0; run < RUNS; run++) {
+		double total = 0;
+		double start = now();
+		for (int i = 0; i < INGREDIENTS; i++) {
+			total += arithmeticQuality(ingredients[i]);
+		}
+		double elapsed = now() - start;
+		*sum += total;
+		best = (run == 0 || elapsed < best) ? elapsed : best;
+	}
+	return best;
+}
+
+int main() {
+	Ingredient* ingredients = malloc(sizeof(Ingredient) * INGREDIENTS);
+	if (ingredients == NULL) {
+		return 1;
+	}
+	srand(1);
+	for (int i = 0; i < INGREDIENTS; i++) {
+		ingredients[i] = ingredientInitialize("Ingredient", PARVE,
+						rand() % (INGREDIENT_MAX_CALORIES + 1),
+						rand() % (INGREDIENT_MAX_HEALTH + 1), 1, NULL);
+	}
+	double tableSum = 0, arithmeticSum = 0;
+	double table = timeTable(ingredients, &tableSum);
+	double arithmetic = timeArithmetic(ingredients, &arithmeticSum);
+	printf("%-26s %10s\n", "path", "ns/call");
+	printf("%-26s %10.2f\n", "ingredientGetQuality", table / INGREDIENTS * 1e9);
+	printf("%-26s %10.2f\n", "inline arithmetic", arithmetic / INGREDIENTS * 1e9);
+	printf("(sums %s: %.17g)\n", tableSum == arithmeticSum ? "match" : "differ",
+			tableSum);
+	free(ingredients);
+	return 0;
+}
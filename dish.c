@@ -1,7 +1,513 @@
 #include "dish.h"
+#ifdef DISH_CHECK_AGGREGATES
+#include <assert.h>
+#endif
 
 
+static char* dishInlineName(Dish dish) {
+	return dish->strings;
+}
+
+#define DISH_INITIAL_CAPACITY 4
+
+/* a ValidIngredient array is read as the Ingredient array it wraps */
+typedef char validIngredientMatches[sizeof(ValidIngredient) ==
+									sizeof(Ingredient) ? 1 : -1];
+
+static size_t storageSize(int capacity) {
+	return sizeof(struct dish_storage_t) + sizeof(Ingredient)*capacity;
+}
+
+static DishStorage storageCreate(int capacity, bool indexNames) {
+	DishStorage storage = (DishStorage)malloc(storageSize(capacity));
+	if (storage == NULL) {
+		return NULL;
+	}
+	storage->references = 1;
+	storage->capacity = capacity;
+	storage->names = NULL;
+	if (indexNames) {
+		storage->names = nameSetCreate(0);
+		if (storage->names == NULL) {
+			free(storage);
+			return NULL;
+		}
+	}
+	return storage;
+}
+
+/*
+ * Clones of a dish may live on different threads, so the reference count is
+ * atomic. The last release acquires every other clone's writes before freeing.
+ */
+static void storageRetain(DishStorage storage) {
+	__atomic_fetch_add(&storage->references,1,__ATOMIC_ACQ_REL);
+}
+
+static bool storageIsExclusive(DishStorage storage) {
+	return __atomic_load_n(&storage->references,__ATOMIC_ACQUIRE) == 1;
+}
+
+static void storageRelease(DishStorage storage) {
+	if (__atomic_fetch_sub(&storage->references,1,__ATOMIC_ACQ_REL) == 1) {
+		nameSetDestroy(storage->names);
+		free(storage);
+	}
+}
+
+/*
+ * Doubles @capacity until it holds @count ingredients, without going past the
+ * dish's maxIngredients.
+ */
+static int storageGrownCapacity(Dish dish, int capacity, int count) {
+	while (capacity < count) {
+		if (capacity > dish->maxIngredients/2) {
+			return dish->maxIngredients;
+		}
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+/*
+ * Gives the dish a storage block of its own with room for @count ingredients
+ * before it's modified. The block is copied if it's shared with clones, and
+ * grown if it's too small.
+ */
+static DishResult dishMakeStorageWritable(Dish dish, int count) {
+	DishStorage shared = dish->storage;
+	bool exclusive = storageIsExclusive(shared);
+	if (exclusive && shared->capacity >= count) {
+		return DISH_SUCCESS;
+	}
+	int capacity = storageGrownCapacity(dish,shared->capacity,count);
+	if (exclusive) {
+		DishStorage grown = (DishStorage)realloc(shared,storageSize(capacity));
+		if (grown == NULL) {
+			return DISH_OUT_OF_MEMORY;
+		}
+		grown->capacity = capacity;
+		dish->storage = grown;
+		dish->ingredients = grown->items;
+		return DISH_SUCCESS;
+	}
+	DishStorage storage = storageCreate(capacity,false);
+	if (storage == NULL) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	if (shared->names != NULL) {
+		storage->names = nameSetCopy(shared->names);
+		if (storage->names == NULL) {
+			free(storage);
+			return DISH_OUT_OF_MEMORY;
+		}
+	}
+	memcpy(storage->items,shared->items,
+			sizeof(Ingredient)*dish->currentIngredients);
+	storageRelease(shared);
+	dish->storage = storage;
+	dish->ingredients = storage->items;
+	return DISH_SUCCESS;
+}
+
+static bool isValidKosherType(KosherType kosherType) {
+	return (kosherType >= 0 && kosherType < INGREDIENT_KOSHER_TYPE_VALUES);
+}
+
+/*
+ * Same rule as ingredientsAreKosher, checked against every ingredient counted
+ * in @kosherCounts at once.
+ */
+static bool isKosherWithCounts(const int* kosherCounts, KosherType kosherType) {
+	if (kosherType == MEATY) {
+		return kosherCounts[MILKY] == 0;
+	}
+	if (kosherType == MILKY) {
+		return kosherCounts[MEATY] == 0;
+	}
+	return true;
+}
+
+static bool dishIsKosherWith(Dish dish, KosherType kosherType) {
+	return isKosherWithCounts(dish->kosherCounts,kosherType);
+}
+
+static DishCost dishCostOf(Ingredient ingredient) {
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	return ingredientGetCostMicros(ingredient);
+#else
+	return ingredient.cost;
+#endif
+}
+
+/*
+ * The total cost of the dish's ingredients: the cost sum, plus the rounding
+ * error kept aside by dishAddCost unless costs are fixed-point.
+ */
+static DishCost dishCostTotal(Dish dish) {
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	return dish->costSum;
+#else
+	return dish->costSum+dish->costCompensation;
+#endif
+}
+
+#ifdef DISH_CHECK_AGGREGATES
+static bool aggregateEquals(double cached, double computed) {
+	return fabs(cached-computed) <= 1e-6*fmax(1,fabs(computed));
+}
+
+static void dishCheckAggregates(Dish dish) {
+	DishCost costSum = 0;
+	double qualitySum = 0;
+	for (int i=0;i<dish->currentIngredients;i++) {
+		costSum += dishCostOf(dish->ingredients[i]);
+		qualitySum += ingredientGetQuality(dish->ingredients[i]);
+	}
+	assert(aggregateEquals(dishCostTotal(dish),costSum));
+	assert(aggregateEquals(dish->qualitySum,qualitySum));
+}
+#else
+#define dishCheckAggregates(dish) ((void)(dish))
+#endif
+
+static uint64_t dishLoadTastings(Dish dish) {
+	if (dish->flags & DISH_CONCURRENT_TASTING) {
+		return __atomic_load_n(&dish->tastings,__ATOMIC_RELAXED);
+	}
+	return dish->tastings;
+}
+
+static bool dishWasTasted(Dish dish) {
+	return dishLoadTastings(dish) != 0;
+}
+
+/*
+ * A plain floating point sum can't give a cost back: once 1e16 has absorbed a
+ * cost of 1, subtracting the 1e16 leaves 0 instead of 1. Unless costs are
+ * fixed-point, costs are added with Neumaier's compensated summation, which
+ * keeps the rounding error of every addition in costCompensation, so removing
+ * a cost is adding its negation and the 1 survives in the compensation.
+ */
+static void dishAddCost(Dish dish, DishCost cost) {
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	dish->costSum += cost;
+#else
+	double sum = dish->costSum+cost;
+	if (fabs(dish->costSum) >= fabs(cost)) {
+		dish->costCompensation += (dish->costSum-sum)+cost;
+	} else {
+		dish->costCompensation += (cost-sum)+dish->costSum;
+	}
+	dish->costSum = sum;
+#endif
+}
+
+/*
+ * Batches add their costs one by one with dishAddCost, and pass a @cost of 0
+ * here along with their total quality.
+ */
+static void dishAddAggregates(Dish dish, DishCost cost, double quality) {
+	dishAddCost(dish,cost);
+	dish->qualitySum += quality;
+	dishCheckAggregates(dish);
+}
+
+/*
+ * Takes a cost and a quality out of the sums in O(1). Both sums restart from
+ * an exact 0 whenever the dish becomes empty.
+ */
+static void dishRemoveAggregates(Dish dish, DishCost cost, double quality) {
+	dishAddCost(dish,-cost);
+	dish->qualitySum -= quality;
+	if (dish->currentIngredients == 0) {
+		dish->costSum = 0;
+#ifndef INGREDIENT_FIXED_POINT_COSTS
+		dish->costCompensation = 0;
+#endif
+		dish->qualitySum = 0;
+	}
+	dishCheckAggregates(dish);
+}
+
+/*
+ * Takes a removed ingredient out of the kosher counts and the name index.
+ * The aggregates are left to the caller.
+ */
+static void dishForgetIngredient(Dish dish, Ingredient removed) {
+	if (isValidKosherType(removed.kosherType)) {
+		dish->kosherCounts[removed.kosherType]--;
+	}
+	nameSetRemove(dish->storage->names,ingredientPeekName(&removed));
+}
+
+/*
+ * Checks a batch of ingredients as adding them one by one would, stopping at
+ * the first one that would fail. Each ingredient is validated as well unless
+ * the batch is known to be valid.
+ */
+static DishResult dishCheckBatch(Dish dish, const Ingredient* ingredients,
+								int count, bool validate) {
+	int kosherCounts[INGREDIENT_KOSHER_TYPE_VALUES];
+	memcpy(kosherCounts,dish->kosherCounts,sizeof(kosherCounts));
+	for (int i=0;i<count;i++) {
+		if (validate &&
+				ingredientValidate(ingredients[i]) != INGREDIENT_SUCCESS) {
+			return DISH_BAD_INGREDIENT;
+		}
+		if (dish->currentIngredients+i == dish->maxIngredients) {
+			return DISH_IS_FULL;
+		}
+		KosherType kosherType = ingredients[i].kosherType;
+		if (!isKosherWithCounts(kosherCounts,kosherType)) {
+			return DISH_KOSHER_VIOLATION;
+		}
+		if (dishWasTasted(dish)) {
+			return DISH_ALREADY_TASTED;
+		}
+		if (isValidKosherType(kosherType)) {
+			kosherCounts[kosherType]++;
+		}
+	}
+	return DISH_SUCCESS;
+}
+
+static DishResult dishAddName(NameSet names, const char* name) {
+	NameSetResult result = nameSetAdd(names,name);
+	if (result == NAME_SET_OUT_OF_MEMORY) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	return result == NAME_SET_SUCCESS ? DISH_SUCCESS : DISH_BAD_INGREDIENT;
+}
+
+static DishResult dishRecordError(IngredientRecordResult result) {
+	if (result == INGREDIENT_RECORD_OUT_OF_MEMORY) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	return result == INGREDIENT_RECORD_NULL_ARGUMENT ? DISH_NULL_ARGUMENT :
+													DISH_BAD_INGREDIENT;
+}
+
+static void dishNotifyRename(Dish dish, const char* name) {
+	if (dish->renameHook != NULL) {
+		dish->renameHook(dish->renameOwner,dish,name);
+	}
+}
+
+static int compareIndexes(const void* index1, const void* index2) {
+	int first = *(const int*)index1;
+	int second = *(const int*)index2;
+	return (first > second) - (first < second);
+}
+
+/*
+ * Places @indexes in @sorted in ascending order, without repeated indexes.
+ * Returns the number of distinct indexes.
+ */
+static int sortedDistinctIndexes(const int* indexes, int count, int* sorted) {
+	memcpy(sorted,indexes,sizeof(int)*count);
+	qsort(sorted,count,sizeof(int),compareIndexes);
+	int distinct = 0;
+	for (int i=0;i<count;i++) {
+		if (distinct == 0 || sorted[distinct-1] != sorted[i]) {
+			sorted[distinct++] = sorted[i];
+		}
+	}
+	return distinct;
+}
+
+/*
+ * Removes the ingredients at the given sorted, distinct indexes, moving each
+ * run of kept ingredients down once.
+ */
+static void dishCompactIngredients(Dish dish, const int* sorted, int count) {
+	int kept = sorted[0];
+	for (int i=0;i<count;i++) {
+		int next = (i+1 < count) ? sorted[i+1] : dish->currentIngredients;
+		int run = next-sorted[i]-1;
+		memmove(dish->ingredients+kept,dish->ingredients+sorted[i]+1,
+				sizeof(Ingredient)*run);
+		kept += run;
+	}
+}
+
+/*
+ * Removes the ingredients at the given sorted, distinct indexes by moving the
+ * last ingredient into each, from the highest index down, so the moved
+ * ingredient is never one that is still to be removed.
+ */
+static void dishSwapOutIngredients(Dish dish, const int* sorted, int count) {
+	int last = dish->currentIngredients-1;
+	for (int i=count-1;i>=0;i--,last--) {
+		dish->ingredients[sorted[i]] = dish->ingredients[last];
+	}
+}
+
+#ifdef INGREDIENT_INTERNED_NAMES
+static int compareNameIds(const void* id1, const void* id2) {
+	unsigned int first = *(const unsigned int*)id1;
+	unsigned int second = *(const unsigned int*)id2;
+	return (first > second) - (first < second);
+}
+
+/*
+ * Interned names are equal iff their ids are, so once the ids are sorted any
+ * duplicates are next to each other.
+ */
+static DishResult dishFindDuplicateNames(Dish dish, bool* areDuplicate) {
+	unsigned int* ids = (unsigned int*)malloc(sizeof(unsigned int)*
+											dish->currentIngredients);
+	if (ids == NULL) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	for (int i=0;i<dish->currentIngredients;i++) {
+		ids[i] = dish->ingredients[i].name.id;
+	}
+	qsort(ids,dish->currentIngredients,sizeof(unsigned int),compareNameIds);
+	for (int i=1;i<dish->currentIngredients && !*areDuplicate;i++) {
+		*areDuplicate = (ids[i] == ids[i-1]);
+	}
+	free(ids);
+	return DISH_SUCCESS;
+}
+#else
+static DishResult dishFindDuplicateNames(Dish dish, bool* areDuplicate) {
+	NameSet names = nameSetCreate(dish->currentIngredients);
+	if (names == NULL) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	for (int i = 0;i<dish->currentIngredients && !*areDuplicate;i++) {
+		if (nameSetAdd(names,dish->ingredients[i].name) != NAME_SET_SUCCESS) {
+			nameSetDestroy(names);
+			return DISH_OUT_OF_MEMORY;
+		}
+		*areDuplicate = (nameSetDuplicates(names) > 0);
+	}
+	nameSetDestroy(names);
+	return DISH_SUCCESS;
+}
+#endif
+
+/*
+ * Allocates a dish header followed by its name and cook, with no ingredient
+ * storage yet.
+ */
+static Dish dishAllocate(const char* name, const char* cook,
+						int maxIngredients) {
+	size_t nameLength = strlen(name);
+	size_t cookLength = strlen(cook);
+	Dish dish = (Dish)malloc(sizeof(*dish) +
+							sizeof(char)*(nameLength+1+cookLength+1));
+	if (dish == NULL) {
+		return NULL;
+	}
+	dish->maxIngredients = maxIngredients;
+	dish->currentIngredients = 0;
+	dish->tastings = 0;
+	dish->renameHook = NULL;
+	dish->renameOwner = NULL;
+	
+	dish->name = dishInlineName(dish);
+	dish->nameCapacity = nameLength;
+	strcpy(dish->name,name);
+	
+	dish->cook = dish->name + nameLength + 1;
+	strcpy(dish->cook,cook);
+	return dish;
+}
+
+/*
+ * Adds an ingredient that is already known to be valid, copying it as is.
+ */
+static DishResult dishInsertIngredient(Dish dish, Ingredient ingredient) {
+	if (dish->currentIngredients == dish->maxIngredients) {
+		return DISH_IS_FULL;
+	}
+	if (!dishIsKosherWith(dish,ingredient.kosherType)) {
+		return DISH_KOSHER_VIOLATION;
+	}
+	if (dishWasTasted(dish)) {
+		return DISH_ALREADY_TASTED;
+	}
+	if (dishMakeStorageWritable(dish,dish->currentIngredients+1) !=
+															DISH_SUCCESS) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	Ingredient* added = dish->ingredients + dish->currentIngredients;
+	*added = ingredient;
+	NameSet names = dish->storage->names;
+	if (names != NULL) {
+		DishResult result = dishAddName(names,ingredientPeekName(added));
+		if (result != DISH_SUCCESS) {
+			return result;
+		}
+	}
+	dish->currentIngredients++;
+	if (isValidKosherType(ingredient.kosherType)) {
+		dish->kosherCounts[ingredient.kosherType]++;
+	}
+	dishAddAggregates(dish,dishCostOf(ingredient),
+					ingredientGetQuality(ingredient));
+	return DISH_SUCCESS;
+}
+
+/*
+ * Adds a batch of ingredients, all of them or none. Unless @validate is set
+ * the batch is known to be valid, as when it came from ValidIngredients.
+ */
+static DishResult dishInsertIngredients(Dish dish,
+				const Ingredient* ingredients, int count, bool validate) {
+	DishResult result = dishCheckBatch(dish,ingredients,count,validate);
+	if (result != DISH_SUCCESS) {
+		return result;
+	}
+	/*
+	 * The ingredients may be the dish's own, which making the storage
+	 * writable can move, so they are found again by their index.
+	 */
+	uintptr_t address = (uintptr_t)ingredients;
+	uintptr_t items = (uintptr_t)dish->ingredients;
+	bool isOwn = address >= items &&
+			address < (uintptr_t)(dish->ingredients+dish->currentIngredients);
+	int ownIndex = isOwn ? (int)(ingredients-dish->ingredients) : 0;
+	if (dishMakeStorageWritable(dish,dish->currentIngredients+count) !=
+															DISH_SUCCESS) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	if (isOwn) {
+		ingredients = dish->ingredients+ownIndex;
+	}
+	Ingredient* added = dish->ingredients + dish->currentIngredients;
+	memcpy(added,ingredients,sizeof(Ingredient)*count);
+	NameSet names = dish->storage->names;
+	for (int i=0;names != NULL && i<count;i++) {
+		result = dishAddName(names,ingredientPeekName(added+i));
+		if (result != DISH_SUCCESS) {
+			while (i-- > 0) {
+				nameSetRemove(names,ingredientPeekName(added+i));
+			}
+			return result;
+		}
+	}
+	double qualityAdded = 0;
+	for (int i=0;i<count;i++) {
+		if (isValidKosherType(added[i].kosherType)) {
+			dish->kosherCounts[added[i].kosherType]++;
+		}
+		dishAddCost(dish,dishCostOf(added[i]));
+		qualityAdded += ingredientGetQuality(added[i]);
+	}
+	dish->currentIngredients += count;
+	dishAddAggregates(dish,0,qualityAdded);
+	return DISH_SUCCESS;
+}
+
 Dish dishCreate(const char* name, const char* cook, int maxIngredients) {
+	return dishCreateWithFlags(name,cook,maxIngredients,DISH_DEFAULT);
+}
+
+Dish dishCreateWithFlags(const char* name, const char* cook,
+						int maxIngredients, int flags) {
 	if (name == NULL) {
 		return NULL;
 	}
@@ -14,36 +520,27 @@ Dish dishCreate(const char* name, const char* cook, int maxIngredients) {
 		return NULL;
 	}
 	
-	Dish dish = (Dish)malloc(sizeof(*dish));
+	Dish dish = dishAllocate(name,cook,maxIngredients);
 	if (dish == NULL) {
 		return NULL;
 	}
-	dish->name = (char*)malloc(sizeof(char)*(strlen(name)+1));
-	if (dish->name == NULL) {
-		dishDestroy(dish);
-		return NULL;
-	}
-	strcpy(dish->name,name);
-	
-	dish->cook = (char*)malloc(sizeof(char)*(strlen(cook)+1));
-	if (dish->cook == NULL) {
-		dishDestroy(dish);
-		return NULL;
-	}
-	strcpy(dish->cook,cook);
-	dish->maxIngredients = maxIngredients;
-	dish->currentIngredients = 0;
-	dish->tasted = 0;
-	dish->liked = 0;
-	
-	dish->ingredients=(Ingredient**)malloc(sizeof(Ingredient*)*maxIngredients);
-	if (dish->ingredients == NULL) {
-		dishDestroy(dish);
+	int capacity = maxIngredients < DISH_INITIAL_CAPACITY ? maxIngredients :
+														DISH_INITIAL_CAPACITY;
+	dish->storage = storageCreate(capacity,flags & DISH_INDEX_NAMES);
+	if (dish->storage == NULL) {
+		free(dish);
 		return NULL;
 	}
-	for (int i=0;i<maxIngredients;i++) {
-		dish->ingredients[i] = NULL;
+	dish->ingredients = dish->storage->items;
+	for (int i=0;i<INGREDIENT_KOSHER_TYPE_VALUES;i++) {
+		dish->kosherCounts[i] = 0;
 	}
+	dish->costSum = 0;
+#ifndef INGREDIENT_FIXED_POINT_COSTS
+	dish->costCompensation = 0;
+#endif
+	dish->qualitySum = 0;
+	dish->flags = flags;
 	return dish;
 }
 
@@ -51,12 +548,10 @@ void dishDestroy(Dish dish) {
 	if (dish == NULL) {
 		return;
 	}
-	free(dish->name);
-	free(dish->cook);
-	for (int i=0;i<dish->maxIngredients;i++) {
-		free(dish->ingredients[i]);
+	if (dish->name != dishInlineName(dish)) {
+		free(dish->name);
 	}
-	free(dish->ingredients);
+	storageRelease(dish->storage);
 	free(dish);
 }
 
@@ -70,77 +565,156 @@ Dish dishClone(Dish source) {
 	if (source->cook == NULL) {
 		return NULL;
 	}
-	Dish dish = dishCreate(source->name,source->cook,source->maxIngredients);
-	Ingredient ingredient;
-	Ingredient sourceIngredient;
-	IngredientResult result = INGREDIENT_SUCCESS;
-	char name[INGREDIENT_MAX_NAME_LENGTH+1];
-	for (int i=0;i<source->maxIngredients;i++) {
-		if (source->ingredients[i] != NULL) {
-			sourceIngredient = *(source->ingredients[i]);
-			
-			result = ingredientGetName(sourceIngredient,name,
-										INGREDIENT_MAX_NAME_LENGTH);
-			if (result != INGREDIENT_SUCCESS) {
-				dishDestroy(dish);
-				return NULL;
-			}
-			
-			ingredient = ingredientInitialize(name, sourceIngredient.kosherType,
-							sourceIngredient.calories, sourceIngredient.health,
-							sourceIngredient.cost, &result);
-			if (result != INGREDIENT_SUCCESS) {
-				dishDestroy(dish);
-				return NULL;
-			}
-			if (dishAddIngredient(dish,ingredient) != DISH_SUCCESS) {
-				dishDestroy(dish);
-				return NULL;
-			}
-		}
+	Dish dish = dishAllocate(source->name,source->cook,source->maxIngredients);
+	if (dish == NULL) {
+		return NULL;
 	}
+	dish->storage = source->storage;
+	storageRetain(dish->storage);
+	dish->ingredients = source->ingredients;
+	dish->currentIngredients = source->currentIngredients;
+	memcpy(dish->kosherCounts,source->kosherCounts,sizeof(dish->kosherCounts));
+	dish->costSum = source->costSum;
+#ifndef INGREDIENT_FIXED_POINT_COSTS
+	dish->costCompensation = source->costCompensation;
+#endif
+	dish->qualitySum = source->qualitySum;
+	dish->flags = source->flags;
 	return dish;
 }
 
 DishResult dishAddIngredient(Dish dish, Ingredient ingredient) {
 	CHECK_NULL_ARG(dish)
-	if (dish->currentIngredients == dish->maxIngredients) {
-		return DISH_IS_FULL;
+	if (ingredientValidate(ingredient) != INGREDIENT_SUCCESS) {
+		return DISH_BAD_INGREDIENT;
 	}
-	for (int i = 0;i < dish->currentIngredients;i++) {
-		if (ingredientsAreKosher(ingredient,*(dish->ingredients[i])) == false) {
-			return DISH_KOSHER_VIOLATION;
-		}
+	return dishInsertIngredient(dish,ingredient);
+}
+
+DishResult dishAddValidIngredient(Dish dish, ValidIngredient ingredient) {
+	CHECK_NULL_ARG(dish)
+	return dishInsertIngredient(dish,ingredient.ingredient);
+}
+
+DishResult dishAddIngredients(Dish dish, const Ingredient* ingredients,
+								int count) {
+	CHECK_NULL_ARG(dish)
+	if (count <= 0) {
+		return DISH_SUCCESS;
 	}
-	if (dish->tasted != 0) {
-		return DISH_ALREADY_TASTED;
+	CHECK_NULL_ARG(ingredients)
+	return dishInsertIngredients(dish,ingredients,count,true);
+}
+
+DishResult dishAddValidIngredients(Dish dish,
+							const ValidIngredient* ingredients, int count) {
+	CHECK_NULL_ARG(dish)
+	if (count <= 0) {
+		return DISH_SUCCESS;
+	}
+	CHECK_NULL_ARG(ingredients)
+	return dishInsertIngredients(dish,(const Ingredient*)ingredients,count,
+								false);
+}
+
+DishResult dishGetAllowedKosherTypes(Dish dish, bool* kosherTypes) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(kosherTypes)
+	for (int i=0;i<INGREDIENT_KOSHER_TYPE_VALUES;i++) {
+		kosherTypes[i] = dishIsKosherWith(dish,(KosherType)i);
 	}
-	dish->ingredients[dish->currentIngredients] = 
-										(Ingredient*)malloc(sizeof(Ingredient));
-	*(dish->ingredients[dish->currentIngredients])=
-					ingredientInitialize(ingredient.name, ingredient.kosherType,
-				ingredient.calories, ingredient.health, ingredient.cost, NULL);
-	dish->currentIngredients++;
 	return DISH_SUCCESS;
 }
 
-DishResult dishRemoveIngredient(Dish dish, int index) {
+DishResult dishAddIngredientRecord(Dish dish, IngredientRecordNames names,
+									IngredientRecord record) {
 	CHECK_NULL_ARG(dish)
-	if ((0 > index) || (index > dish->maxIngredients-1)) {
-		return DISH_INGREDIENT_NOT_FOUND;
+	Ingredient ingredient;
+	IngredientRecordResult result = ingredientRecordUnpack(names,record,
+														&ingredient);
+	if (result != INGREDIENT_RECORD_SUCCESS) {
+		return dishRecordError(result);
+	}
+	return dishAddIngredient(dish,ingredient);
+}
+
+DishResult dishGetIngredientRecords(Dish dish, IngredientRecordNames names,
+									IngredientRecord* records) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(records)
+	IngredientRecordResult result = ingredientRecordPackArray(names,
+					dish->ingredients,dish->currentIngredients,records);
+	if (result != INGREDIENT_RECORD_SUCCESS) {
+		return dishRecordError(result);
 	}
-	if (dish->ingredients[index] == NULL) {
+	return DISH_SUCCESS;
+}
+
+DishResult dishRemoveIngredient(Dish dish, int index) {
+	CHECK_NULL_ARG(dish)
+	if ((0 > index) || (index > dish->currentIngredients-1)) {
 		return DISH_INGREDIENT_NOT_FOUND;
 	}
-	if (dish->tasted != 0) {
+	if (dishWasTasted(dish)) {
 		return DISH_ALREADY_TASTED;
 	}
-	free(dish->ingredients[index]);
-	for (int i=index+1;i<dish->currentIngredients;i++) {
-		dish->ingredients[i-1] = dish->ingredients[i];
+	if (dishMakeStorageWritable(dish,dish->currentIngredients) !=
+															DISH_SUCCESS) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	Ingredient removed = dish->ingredients[index];
+	dishForgetIngredient(dish,removed);
+	if (dish->flags & DISH_UNORDERED) {
+		dish->ingredients[index] = dish->ingredients[dish->currentIngredients-1];
+	} else {
+		memmove(dish->ingredients+index, dish->ingredients+index+1,
+				sizeof(Ingredient)*(dish->currentIngredients-index-1));
 	}
-	dish->ingredients[dish->currentIngredients-1] = NULL;
 	dish->currentIngredients--;
+	dishRemoveAggregates(dish,dishCostOf(removed),
+						ingredientGetQuality(removed));
+	return DISH_SUCCESS;
+}
+
+DishResult dishRemoveIngredients(Dish dish, const int* indexes, int count) {
+	CHECK_NULL_ARG(dish)
+	if (count <= 0) {
+		return DISH_SUCCESS;
+	}
+	CHECK_NULL_ARG(indexes)
+	int* sorted = (int*)malloc(sizeof(int)*count);
+	if (sorted == NULL) {
+		return DISH_OUT_OF_MEMORY;
+	}
+	count = sortedDistinctIndexes(indexes,count,sorted);
+	DishResult result = DISH_SUCCESS;
+	if (sorted[0] < 0 || sorted[count-1] > dish->currentIngredients-1) {
+		result = DISH_INGREDIENT_NOT_FOUND;
+	} else if (dishWasTasted(dish)) {
+		result = DISH_ALREADY_TASTED;
+	} else if (dishMakeStorageWritable(dish,dish->currentIngredients) !=
+																DISH_SUCCESS) {
+		result = DISH_OUT_OF_MEMORY;
+	}
+	if (result != DISH_SUCCESS) {
+		free(sorted);
+		return result;
+	}
+	double qualityRemoved = 0;
+	for (int i=0;i<count;i++) {
+		Ingredient removed = dish->ingredients[sorted[i]];
+		dishForgetIngredient(dish,removed);
+		dishAddCost(dish,-dishCostOf(removed));
+		qualityRemoved += ingredientGetQuality(removed);
+	}
+	if (dish->flags & DISH_UNORDERED) {
+		dishSwapOutIngredients(dish,sorted,count);
+	} else {
+		dishCompactIngredients(dish,sorted,count);
+	}
+	dish->currentIngredients -= count;
+	dishRemoveAggregates(dish,0,qualityRemoved);
+	free(sorted);
 	return DISH_SUCCESS;
 }
 
@@ -168,16 +742,70 @@ DishResult dishGetCook(Dish dish, char** cook) {
 	return DISH_SUCCESS;
 }
 
+DishResult dishPeekName(Dish dish, const char** name) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(name)
+	*name = dish->name;
+	return DISH_SUCCESS;
+}
+
+DishResult dishPeekCook(Dish dish, const char** cook) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(cook)
+	*cook = dish->cook;
+	return DISH_SUCCESS;
+}
+
+static DishResult copyString(const char* string, char* buffer, int length) {
+	CHECK_NULL_ARG(buffer)
+	if (length < 0 || strlen(string) >= (size_t)length) {
+		return DISH_SMALL_BUFFER;
+	}
+	strcpy(buffer,string);
+	return DISH_SUCCESS;
+}
+
+DishResult dishCopyName(Dish dish, char* buffer, int length) {
+	CHECK_NULL_ARG(dish)
+	return copyString(dish->name,buffer,length);
+}
+
+DishResult dishCopyCook(Dish dish, char* buffer, int length) {
+	CHECK_NULL_ARG(dish)
+	return copyString(dish->cook,buffer,length);
+}
+
 DishResult dishSetName(Dish dish, const char* name) {
 	CHECK_NULL_ARG(dish)
 	CHECK_NULL_ARG(name)
-	char * newName = (char*)malloc(sizeof(char)*(strlen(name)+1));
+	int length = strlen(name);
+	if (length <= dish->nameCapacity) {
+		dishNotifyRename(dish,name);
+		memmove(dish->name,name,sizeof(char)*(length+1));
+		return DISH_SUCCESS;
+	}
+	char * newName = (char*)malloc(sizeof(char)*(length+1));
 	if (newName == NULL) {
 		return DISH_OUT_OF_MEMORY;
 	}
 	strcpy(newName,name);
-	free(dish->name);
+	dishNotifyRename(dish,name);
+	if (dish->name != dishInlineName(dish)) {
+		free(dish->name);
+	}
 	dish->name = newName;
+	dish->nameCapacity = length;
+	return DISH_SUCCESS;
+}
+
+DishResult dishSetRenameHook(Dish dish, DishRenameHook hook, void* owner) {
+	CHECK_NULL_ARG(dish)
+	if (dish->renameHook != NULL &&
+			(hook != NULL || owner != dish->renameOwner)) {
+		return DISH_RENAME_HOOK_IN_USE;
+	}
+	dish->renameHook = hook;
+	dish->renameOwner = hook != NULL ? owner : NULL;
 	return DISH_SUCCESS;
 }
 
@@ -188,22 +816,23 @@ DishResult dishAreDuplicateIngredients(Dish dish, bool* areDuplicate) {
 	if (dish->currentIngredients == 0) {
 		return DISH_IS_EMPTY;
 	}
-	for (int i = 0;i<dish->currentIngredients;i++) {
-		for (int j = i+1;j<dish->currentIngredients;j++) {
-			if (strcmp(dish->ingredients[i]->name,
-						dish->ingredients[j]->name) == 0) {
-				*areDuplicate = true;
-			}
-		}
+	if (dish->storage->names != NULL) {
+		*areDuplicate = (nameSetDuplicates(dish->storage->names) > 0);
+		return DISH_SUCCESS;
 	}
-	return DISH_SUCCESS;
+	return dishFindDuplicateNames(dish,areDuplicate);
 }
 
 DishResult dishTaste(Dish dish, bool liked) {
 	CHECK_NULL_ARG(dish)
-	dish->tasted++;
+	uint64_t tasting = UINT64_C(1) << DISH_TASTINGS_SHIFT;
 	if (liked == true) {
-		dish->liked++;
+		tasting++;
+	}
+	if (dish->flags & DISH_CONCURRENT_TASTING) {
+		__atomic_fetch_add(&dish->tastings,tasting,__ATOMIC_RELAXED);
+	} else {
+		dish->tastings += tasting;
 	}
 	return DISH_SUCCESS;
 }
@@ -211,11 +840,13 @@ DishResult dishTaste(Dish dish, bool liked) {
 DishResult dishHowMuchTasty(Dish dish, double* tastiness) {
 	CHECK_NULL_ARG(dish)
 	CHECK_NULL_ARG(tastiness)
-	if (dish->tasted == 0) {
+	uint64_t tastings = dishLoadTastings(dish);
+	uint64_t tasted = tastings >> DISH_TASTINGS_SHIFT;
+	if (tasted == 0) {
 		return DISH_NEVER_TASTED;
 	}
-	*tastiness = (double)(dish->liked);
-	*tastiness /= dish->tasted;
+	*tastiness = (double)(tastings & DISH_TASTINGS_LIKED_MASK);
+	*tastiness /= tasted;
 	return DISH_SUCCESS;
 }
 
@@ -225,11 +856,29 @@ DishResult dishGetQuality(Dish dish, double* quality) {
 	if (dish->currentIngredients == 0) {
 		return DISH_IS_EMPTY;
 	}
-	*quality = 0;
-	for (int i=0;i < dish->currentIngredients;i++) {
-		*quality += ingredientGetQuality(*(dish->ingredients[i]));
-	}
-	*quality /= dish->currentIngredients;
+	*quality = dish->qualitySum/dish->currentIngredients;
+	return DISH_SUCCESS;
+}
+
+DishResult dishGetPrice(Dish dish, double* price) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(price)
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	*price = ingredientCostFromMicros(dishCostTotal(dish));
+#else
+	*price = dishCostTotal(dish);
+#endif
+	return DISH_SUCCESS;
+}
+
+DishResult dishGetPriceMicros(Dish dish, int64_t* micros) {
+	CHECK_NULL_ARG(dish)
+	CHECK_NULL_ARG(micros)
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	*micros = dishCostTotal(dish);
+#else
+	*micros = llround(dishCostTotal(dish)*INGREDIENT_COST_MICROS_PER_UNIT);
+#endif
 	return DISH_SUCCESS;
 }
 
@@ -243,7 +892,6 @@ DishResult dishIsBetter(Dish dish1, Dish dish2,
 	}
 	*isBetter = true;
 	double quality1 = 0, quality2 = 0;
-	double cost1 = 0, cost2 = 0;
 	if (dishGetQuality(dish1,&quality1) != DISH_SUCCESS) {
 		return DISH_IS_EMPTY;
 	}
@@ -253,13 +901,8 @@ DishResult dishIsBetter(Dish dish1, Dish dish2,
 	if (quality2 >= quality1) {
 		*isBetter = false;
 	}
-	for (int i = 0; i < dish1->currentIngredients; i++) {
-		cost1 += dish1->ingredients[i]->cost;
-	}
-	for (int i = 0; i < dish2->currentIngredients; i++) {
-		cost2 += dish2->ingredients[i]->cost;
-	}
-	if (cost1 > cost2*(1+flexibility)) {
+	if ((double)dishCostTotal(dish1) >
+						(double)dishCostTotal(dish2)*(1+flexibility)) {
 		*isBetter = false;
 	}
 	return DISH_SUCCESS;
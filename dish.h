@@ -12,10 +12,13 @@
  * Includes
  ******************************************************************************/
 #include "ingredient.h"
+#include "ingredient_record.h"
+#include "name_set.h"
 #include <stdlib.h>
 #include <math.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
 
 
 #define CHECK_NULL_ARG(val) \
@@ -23,18 +26,106 @@
 		return DISH_NULL_ARGUMENT; \
 	}
 
+/*******************************************************************************
+ * Dish Flags
+ ******************************************************************************/
+typedef enum {
+	DISH_DEFAULT = 0,			/* No optional behaviour					  */
+	DISH_INDEX_NAMES = 1 << 0,	/* Keep a hashed index of ingredient names,
+								   making duplicate queries O(1)			  */
+	DISH_CONCURRENT_TASTING = 1 << 1,	/* dishTaste and dishHowMuchTasty may
+										   be called from several threads at
+										   once							  */
+	DISH_UNORDERED = 1 << 2		/* Removing an ingredient moves the last one
+								   into its place instead of shifting the
+								   ones after it, making removal O(1)		  */
+} DishFlags;
+
 /*******************************************************************************
  * Dish Struct
+ *
+ * The dish's ingredients live in a reference counted storage block that
+ * clones share. The block is copied the first time a dish sharing it adds or
+ * removes an ingredient, so a clone that is never modified costs O(1). The
+ * count is updated atomically, so clones may be used from different threads.
+ * ingredients points to the items of the dish's current block.
+ *
+ * A block has room for capacity ingredients. It starts small and doubles as
+ * ingredients are added, up to maxIngredients, so a dish's memory follows
+ * the number of ingredients it holds rather than its maxIngredients.
+ *
+ * The header is followed by the name and the cook strings, which name and
+ * cook point into. A name set by dishSetName that doesn't fit in nameCapacity
+ * is allocated separately.
+ *
+ * kosherCounts holds how many ingredients of each kosher type the dish
+ * contains, so kosher admission doesn't have to scan the ingredients.
+ * costSum and qualitySum are the running totals of the ingredients' costs and
+ * qualities. Compiling with DISH_CHECK_AGGREGATES defined verifies them
+ * against a full recompute after every change. When built with
+ * INGREDIENT_FIXED_POINT_COSTS, costSum counts micro-units in an integer, so
+ * it is exact and doesn't depend on the order ingredients were added in.
+ * Otherwise costCompensation holds the rounding error of the compensated
+ * floating point sum, so removing an ingredient takes exactly its cost back
+ * out in O(1).
+ *
+ * tastings packs the number of times the dish was tasted in its high
+ * DISH_TASTINGS_SHIFT bits and the number of times it was liked in the low
+ * bits, so a single atomic update or load of a DISH_CONCURRENT_TASTING dish
+ * always sees a consistent pair.
+ *
+ * The storage's names is the ingredient name index of a dish created with
+ * DISH_INDEX_NAMES, and NULL otherwise.
+ *
+ * renameHook, when not NULL, is called by dishSetName with renameOwner, so a
+ * collection indexing dishes by name can follow renames. See
+ * dishSetRenameHook. Both are reserved to their owner while set, which for a
+ * dish in a menu is the menu, and must not be written directly.
  ******************************************************************************/
-typedef struct dish_t {
+#define DISH_TASTINGS_SHIFT 32
+#define DISH_TASTINGS_LIKED_MASK ((UINT64_C(1) << DISH_TASTINGS_SHIFT) - 1)
+
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+typedef int64_t DishCost;
+#else
+typedef double DishCost;
+#endif
+
+typedef struct dish_storage_t {
+	int references;
+	int capacity;
+	NameSet names;
+	Ingredient items[];
+}* DishStorage;
+
+typedef struct dish_t* Dish;
+
+/*
+ * Called by dishSetName once the rename can no longer fail, right before the
+ * dish's name is replaced by @name, so the dish still has its old name.
+ */
+typedef void (*DishRenameHook)(void* owner, Dish dish, const char* name);
+
+struct dish_t {
 	char * name;
 	char * cook;
-	Ingredient ** ingredients;
+	Ingredient * ingredients;
+	DishStorage storage;
 	int maxIngredients;
 	int currentIngredients;
-	int tasted;
-	int liked;
-}* Dish;
+	uint64_t tastings;
+	int nameCapacity;
+	int kosherCounts[INGREDIENT_KOSHER_TYPE_VALUES];
+	DishCost costSum;
+#ifndef INGREDIENT_FIXED_POINT_COSTS
+	double costCompensation;
+#endif
+	double qualitySum;
+	int flags;
+	DishRenameHook renameHook;
+	void* renameOwner;
+	char strings[];
+};
 
 /*******************************************************************************
  * Return Value Definition
@@ -50,7 +141,12 @@ typedef enum {
 	DISH_IS_EMPTY,				/* The given dish is empty					  */
 	DISH_ALREADY_TASTED,		/* The dish was already tasted				  */
 	DISH_NEVER_TASTED,			/* The dish was never tasted				  */
-	DISH_OUT_OF_MEMORY			/* A memory error occured					  */
+	DISH_OUT_OF_MEMORY,			/* A memory error occured					  */
+	DISH_SMALL_BUFFER,			/* The passed buffer is too small			  */
+	DISH_BAD_INGREDIENT,		/* An ingredient isn't valid, or couldn't be
+								   converted to or from an IngredientRecord	  */
+	DISH_RENAME_HOOK_IN_USE		/* The dish's rename hook is set by another
+								   owner									  */
 } DishResult;
 
 /*
@@ -87,6 +183,18 @@ typedef enum {
  */
 Dish dishCreate(const char* name, const char* cook, int maxIngredients);
 
+/*
+ * Create a new empty dish, like dishCreate, with optional behaviours.
+ *
+ * @param name The dish's name
+ * @param cook The cook's name
+ * @param maxIngredients The maximal number of ingredients the dish may hold.
+ * @param flags DishFlags values combined with |, or DISH_DEFAULT.
+ * @return The newly created dish, or NULL if any error occured.
+ */
+Dish dishCreateWithFlags(const char* name, const char* cook,
+						int maxIngredients, int flags);
+
 /*
  * Destroy a given dish, deallocating all necessary memory.
  *
@@ -98,12 +206,16 @@ void dishDestroy(Dish dish);
  * Clones a dish, creating a new dish that's an exact clone of the source dish.
  *
  * The new dish will have the same name, same cook and same ingredients as the
- * source dish. It will also be able to hold the same maximal number of ingredients.
+ * source dish. It will also be able to hold the same maximal number of ingredients,
+ * and it is created with the same flags.
  * The new dish will also have the same ingredients as the source dish.
  *
  * The new dish is, as it's name suggests, new. Hence, no judge ever got a chance
  * to taste it.
  *
+ * The new dish shares the source dish's ingredient storage until either of
+ * them adds or removes an ingredient.
+ *
  * @param source The source dish.
  * @return The new dish, or NULL in any case of error.
  */
@@ -120,12 +232,95 @@ Dish dishClone(Dish source);
  * 	3. The dish was never tasted before.
  * In case one of these terms doesn't apply, an error code should be returned.
  *
+ * The ingredient must also be valid, as ingredientValidate defines it, or
+ * DISH_BAD_INGREDIENT is returned. A valid ingredient is then copied as is.
+ * Ingredients already known to be valid are better added with
+ * dishAddValidIngredient, which doesn't check them again.
+ *
  * @param dish The dish to add to.
  * @param ingredient The ingredient to add.
  * @return Success or error code.
  */
 DishResult dishAddIngredient(Dish dish, Ingredient ingredient);
 
+/*
+ * Add a valid ingredient to a dish under the same terms as
+ * dishAddIngredient. The ingredient isn't validated again, only copied.
+ *
+ * @param dish The dish to add to.
+ * @param ingredient The ingredient to add.
+ * @return Success or error code.
+ */
+DishResult dishAddValidIngredient(Dish dish, ValidIngredient ingredient);
+
+/*
+ * Add @count ingredients to a dish, in order, as if dishAddIngredient was
+ * called for each of them. Either all of them are added or none is: if one
+ * of the calls would fail, its error code is returned and the dish is left
+ * as it was.
+ *
+ * @param dish The dish to add to.
+ * @param ingredients The ingredients to add.
+ * @param count The number of ingredients.
+ * @return Success or error code.
+ */
+DishResult dishAddIngredients(Dish dish, const Ingredient* ingredients,
+								int count);
+
+/*
+ * Add @count valid ingredients to a dish as dishAddIngredients does, but
+ * without validating them again.
+ *
+ * @param dish The dish to add to.
+ * @param ingredients The ingredients to add.
+ * @param count The number of ingredients.
+ * @return Success or error code.
+ */
+DishResult dishAddValidIngredients(Dish dish,
+							const ValidIngredient* ingredients, int count);
+
+/*
+ * Returns which kosher types an ingredient added to the dish may have.
+ * kosherTypes[t] will hold whether an ingredient of kosher type t is kosher
+ * with every ingredient currently in the dish, as ingredientsAreKosher
+ * defines it.
+ *
+ * @param dish The dish to test.
+ * @param kosherTypes An array with room for INGREDIENT_KOSHER_TYPE_VALUES.
+ * @return Success or error code.
+ */
+DishResult dishGetAllowedKosherTypes(Dish dish, bool* kosherTypes);
+
+/*
+ * Add an ingredient given as a packed record (see ingredient_record.h) to a
+ * dish, under the same conditions as dishAddIngredient.
+ * If the record can't be unpacked with @names, DISH_BAD_INGREDIENT is
+ * returned. @names may be NULL only with INGREDIENT_INTERNED_NAMES.
+ *
+ * @param dish The dish to add to.
+ * @param names The names table the record was packed with.
+ * @param record The packed ingredient to add.
+ * @return Success or error code.
+ */
+DishResult dishAddIngredientRecord(Dish dish, IngredientRecordNames names,
+									IngredientRecord record);
+
+/*
+ * Pack the dish's ingredients, in order, into @records, adding their names
+ * to @names.
+ * If one of them can't be packed, DISH_BAD_INGREDIENT is returned and the
+ * content of @records is undefined.
+ * @names may be NULL only with INGREDIENT_INTERNED_NAMES.
+ *
+ * @param dish The dish to read.
+ * @param names The names table the records' name ids come from.
+ * @param records An array with room for the dish's current number of
+ * ingredients.
+ * @return Success or error code.
+ */
+DishResult dishGetIngredientRecords(Dish dish, IngredientRecordNames names,
+									IngredientRecord* records);
+
 /*
  * Remove an ingredient from a dish, using the ingredient's index.
  *
@@ -140,6 +335,23 @@ DishResult dishAddIngredient(Dish dish, Ingredient ingredient);
  */
 DishResult dishRemoveIngredient(Dish dish, int index);
 
+/*
+ * Remove several ingredients from a dish at once, using their indexes before
+ * any of them is removed. An index may appear more than once.
+ *
+ * The remaining ingredients keep their order, unless the dish was created
+ * with DISH_UNORDERED, in which case each removed ingredient is replaced by
+ * the last one as dishRemoveIngredient would do.
+ * If one of the indexes is out of bounds, or the dish was already tasted,
+ * no ingredient is removed.
+ *
+ * @param dish The dish to remove from.
+ * @param indexes The ingredients' indexes.
+ * @param count The number of indexes.
+ * @return Success or error code.
+ */
+DishResult dishRemoveIngredients(Dish dish, const int* indexes, int count);
+
 /*
  * Returns the dish's name.
  * The function should allocate a buffer for the dish's name and return a
@@ -162,6 +374,54 @@ DishResult dishGetName(Dish dish, char** name);
  */
 DishResult dishGetCook(Dish dish, char** cook);
 
+/*
+ * Returns the dish's name without allocating.
+ * The returned string belongs to the dish; it must not be modified or freed,
+ * and it is only valid until the next dishSetName or dishDestroy of the dish.
+ *
+ * @param dish The dish to get the name of.
+ * @param name A pointer to the dish's name will be placed here.
+ * @return Success or error code.
+ */
+DishResult dishPeekName(Dish dish, const char** name);
+
+/*
+ * Returns the dish's cook without allocating.
+ * The returned string belongs to the dish; it must not be modified or freed,
+ * and it is only valid until dishDestroy of the dish.
+ *
+ * @param dish The dish to get the cook of.
+ * @param cook A pointer to the dish's cook will be placed here.
+ * @return Success or error code.
+ */
+DishResult dishPeekCook(Dish dish, const char** cook);
+
+/*
+ * Place the dish's name in the given buffer.
+ *
+ * If the given buffer length is insufficient, DISH_SMALL_BUFFER should
+ * be returned. This should also be returned if the length is negative.
+ *
+ * @param dish The dish to get the name of.
+ * @param buffer The buffer to write the name to.
+ * @param length The length of the given buffer.
+ * @return Success or error code.
+ */
+DishResult dishCopyName(Dish dish, char* buffer, int length);
+
+/*
+ * Place the dish's cook in the given buffer.
+ *
+ * If the given buffer length is insufficient, DISH_SMALL_BUFFER should
+ * be returned. This should also be returned if the length is negative.
+ *
+ * @param dish The dish to get the cook of.
+ * @param buffer The buffer to write the cook to.
+ * @param length The length of the given buffer.
+ * @return Success or error code.
+ */
+DishResult dishCopyCook(Dish dish, char* buffer, int length);
+
 /*
  * Sets the dish's name.
  * Note that changing the passed name after the function ends does not change
@@ -173,9 +433,27 @@ DishResult dishGetCook(Dish dish, char** cook);
  */
 DishResult dishSetName(Dish dish, const char* name);
 
+/*
+ * Set the function dishSetName calls before renaming the dish. A dish has at
+ * most one hook, so if one is already set DISH_RENAME_HOOK_IN_USE is returned
+ * and it is kept; a dish in a menu always has the menu's hook.
+ * Passing a NULL @hook removes the hook, but only for the @owner it was set
+ * with, and DISH_RENAME_HOOK_IN_USE is returned for any other owner.
+ * Clones don't inherit the hook.
+ *
+ * @param dish The dish to watch.
+ * @param hook The function to call, or NULL.
+ * @param owner The value to pass to @hook as its owner.
+ * @return Success or error code.
+ */
+DishResult dishSetRenameHook(Dish dish, DishRenameHook hook, void* owner);
+
 /*
  * Test if there are two ingredients in a dish that have the same name.
  *
+ * This is O(1) for a dish created with DISH_INDEX_NAMES, and a single O(n)
+ * hashing pass otherwise.
+ *
  * If the dish is empty, DISH_IS_EMPTY should be returned, and @areDuplicate
  * will contain the value @{false}.
  *
@@ -189,6 +467,10 @@ DishResult dishAreDuplicateIngredients(Dish dish, bool* areDuplicate);
  * This function is called after a judge tastes a dish, and updates the dish
  * accordingly.
  *
+ * For a dish created with DISH_CONCURRENT_TASTING, several threads may taste
+ * it and ask how tasty it is at the same time. Other functions must not run
+ * concurrently with them on the same dish.
+ *
  * @param dish The dish that was tasted.
  * @param liked Holds whether the judge liked the dish or not.
  * @return Success or error code
@@ -219,6 +501,27 @@ DishResult dishHowMuchTasty(Dish dish, double* tastiness);
  */
 DishResult dishGetQuality(Dish dish, double* quality);
 
+/*
+ * Returns the dish's price, which is the sum of all of it's ingredient's
+ * prices. The price of an empty dish is 0.
+ *
+ * @param dish The dish to get the price of.
+ * @param price The dish's price should be placed here.
+ * @return Success or error code.
+ */
+DishResult dishGetPrice(Dish dish, double* price);
+
+/*
+ * Returns the dish's price in micro-units (see ingredient.h).
+ * When built with INGREDIENT_FIXED_POINT_COSTS the price is exact, so equal
+ * dishes have equal prices on every thread and machine.
+ *
+ * @param dish The dish to get the price of.
+ * @param micros The dish's price in micro-units will be placed here.
+ * @return Success or error code.
+ */
+DishResult dishGetPriceMicros(Dish dish, int64_t* micros);
+
 /*
  * The function returns whether dish1 is better than dish2.
  * We'll say that dish1 is better than dish2 if:
@@ -1,6 +1,7 @@
 #include "dish.h"
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #define ASSERT(expr) do { \
 	if(!(expr)) { \
@@ -36,6 +37,7 @@
 #define ASSERT_EMPTY(expr) ASSERT_EQUALS(expr, DISH_IS_EMPTY)
 #define ASSERT_NEVER_TASTED(expr) ASSERT_EQUALS(expr, DISH_NEVER_TASTED)
 #define ASSERT_ALREADY_TASTED(expr) ASSERT_EQUALS(expr, DISH_ALREADY_TASTED)
+#define ASSERT_BAD_INGREDIENT(expr) ASSERT_EQUALS(expr, DISH_BAD_INGREDIENT)
 
 static bool testCreate() {
 	ASSERT_NULL(dishCreate(NULL,NULL,0));
@@ -110,17 +112,55 @@ static bool testClone() {
 	ASSERT_NEVER_TASTED(dishHowMuchTasty(cpy,&d));
 	char name1[20];
 	char name2[20];
-	ingredientGetName(*(cpy->ingredients[0]),name1, 19);
+	ingredientGetName(cpy->ingredients[0],name1, 19);
 	ingredientGetName(ing,name2,19);
 	ASSERT_STRING_EQUALS(name1,name2);
 	
 	
 	Ingredient red = ingredientInitialize("filet of ish", PARVE, 3, 2, 1, NULL);
 	ASSERT_SUCCESS(dishAddIngredient(cpy,red));
-	
+
 	dishDestroy(src);
 	dishDestroy(cpy);
 
+	src = dishCreate("long names","very long", 3);
+	Ingredient longName = ingredientInitialize(
+			"0123456789012345678901234567890123456789", MILKY, 1, 2, 3, NULL);
+	ASSERT_SUCCESS(dishAddIngredient(src,longName));
+	ASSERT_SUCCESS(dishAddIngredient(src,red));
+	cpy = dishClone(src);
+	ASSERT_NOT_NULL(cpy);
+	ASSERT_EQUALS(cpy->currentIngredients, 2);
+	ASSERT_STRING_EQUALS(ingredientPeekName(&cpy->ingredients[0]),
+						ingredientPeekName(&longName));
+	ASSERT_SUCCESS(dishGetPrice(cpy,&d));
+	ASSERT_DOUBLE_EQUALS(d, 4);
+	ASSERT_KOSHER_VIOLATION(dishAddIngredient(cpy,ing));
+
+	dishDestroy(src);
+	dishDestroy(cpy);
+
+	src = dishCreateWithFlags("shared","sharer", 3, DISH_INDEX_NAMES);
+	dishAddIngredient(src,red);
+	cpy = dishClone(src);
+	ASSERT_EQUALS(cpy->ingredients, src->ingredients);
+	ASSERT_SUCCESS(dishAddIngredient(cpy,red));
+	ASSERT_NOT_EQUALS(cpy->ingredients, src->ingredients);
+	ASSERT_EQUALS(src->currentIngredients, 1);
+	bool isDuplicate;
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(src,&isDuplicate));
+	ASSERT_FALSE(isDuplicate);
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(cpy,&isDuplicate));
+	ASSERT_TRUE(isDuplicate);
+
+	Dish cpy2 = dishClone(src);
+	dishDestroy(src);
+	ASSERT_SUCCESS(dishRemoveIngredient(cpy2,0));
+	ASSERT_EQUALS(cpy2->currentIngredients, 0);
+
+	dishDestroy(cpy);
+	dishDestroy(cpy2);
+
 	return true;
 }
 
@@ -145,8 +185,244 @@ static bool testAddIngredient() {
 	ASSERT_SUCCESS(dishAddIngredient(dish, ing3));
 	dishTaste(dish,true);
 	ASSERT_ALREADY_TASTED(dishAddIngredient(dish, ing1));
-	
-	
+
+	dish = dishCreate("Hafuch", "Al Hafuch", 3);
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing1));
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing3));
+	ASSERT_KOSHER_VIOLATION(dishAddIngredient(dish, ing2));
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 0));
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing2));
+	ASSERT_KOSHER_VIOLATION(dishAddIngredient(dish, ing1));
+	dishDestroy(dish);
+
+	dish = dishCreateWithFlags("Pgumim", "Chef", 3, DISH_INDEX_NAMES);
+	Ingredient bad = ing3;
+	bad.calories = INGREDIENT_MAX_CALORIES + 1;
+	ASSERT_BAD_INGREDIENT(dishAddIngredient(dish, bad));
+	bad = ing3;
+	bad.kosherType = (KosherType)INGREDIENT_KOSHER_TYPE_VALUES;
+	ASSERT_BAD_INGREDIENT(dishAddIngredient(dish, bad));
+	bad = ing3;
+	bad.cost = -1;
+	ASSERT_BAD_INGREDIENT(dishAddIngredient(dish, bad));
+	ASSERT_EQUALS(dish->currentIngredients, 0);
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing3));
+	double price;
+	ASSERT_SUCCESS(dishGetPrice(dish, &price));
+	ASSERT_DOUBLE_EQUALS(price, 1);
+	dishDestroy(dish);
+
+	return true;
+}
+
+static bool testAddIngredients() {
+	Ingredient meaty = ingredientInitialize("Steak", MEATY, 1, 1, 1, NULL);
+	Ingredient milky = ingredientInitialize("Cheese", MILKY, 1, 1, 2, NULL);
+	Ingredient parve = ingredientInitialize("Salt", PARVE, 1, 1, 4, NULL);
+	Ingredient batch[] = { parve, meaty, parve };
+	Ingredient conflict[] = { parve, meaty, milky };
+
+	Dish dish = dishCreateWithFlags("Stew", "Chef", 4, DISH_INDEX_NAMES);
+	ASSERT_NULL_ARGUMENT(dishAddIngredients(NULL, batch, 3));
+	ASSERT_NULL_ARGUMENT(dishAddIngredients(dish, NULL, 3));
+	ASSERT_SUCCESS(dishAddIngredients(dish, NULL, 0));
+
+	ASSERT_KOSHER_VIOLATION(dishAddIngredients(dish, conflict, 3));
+	ASSERT_EQUALS(dish->currentIngredients, 0);
+	Ingredient invalid[] = { parve, meaty, parve };
+	invalid[2].health = INGREDIENT_MAX_HEALTH + 1;
+	ASSERT_BAD_INGREDIENT(dishAddIngredients(dish, invalid, 3));
+	ASSERT_EQUALS(dish->currentIngredients, 0);
+	ASSERT_SUCCESS(dishAddIngredients(dish, batch, 3));
+	ASSERT_EQUALS(dish->currentIngredients, 3);
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[1]), "Steak");
+	double price;
+	ASSERT_SUCCESS(dishGetPrice(dish, &price));
+	ASSERT_DOUBLE_EQUALS(price, 9);
+	bool isDuplicate;
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish, &isDuplicate));
+	ASSERT_TRUE(isDuplicate);
+
+	ASSERT_FULL(dishAddIngredients(dish, batch, 2));
+	ASSERT_KOSHER_VIOLATION(dishAddIngredients(dish, &milky, 1));
+	ASSERT_EQUALS(dish->currentIngredients, 3);
+	ASSERT_SUCCESS(dishAddIngredients(dish, &parve, 1));
+	dishTaste(dish, true);
+	ASSERT_FULL(dishAddIngredients(dish, &parve, 1));
+	dishDestroy(dish);
+
+	dish = dishCreate("Tasted", "Chef", 4);
+	dishTaste(dish, true);
+	ASSERT_ALREADY_TASTED(dishAddIngredients(dish, batch, 3));
+	dishDestroy(dish);
+
+	/* a dish's own ingredients stay readable while its storage grows */
+	dish = dishCreateWithFlags("Twice", "Chef", 8, DISH_INDEX_NAMES);
+	ASSERT_SUCCESS(dishAddIngredients(dish, batch, 3));
+	ASSERT_SUCCESS(dishAddIngredients(dish, dish->ingredients, 3));
+	ASSERT_EQUALS(dish->currentIngredients, 6);
+	for (int i = 0; i < 6; i++) {
+		ASSERT_EQUALS(dish->ingredients[i].kosherType, batch[i % 3].kosherType);
+	}
+	Dish clone = dishClone(dish);
+	ASSERT_SUCCESS(dishAddIngredients(clone, dish->ingredients + 4, 2));
+	ASSERT_STRING_EQUALS(ingredientPeekName(&clone->ingredients[6]), "Steak");
+	ASSERT_SUCCESS(dishGetPrice(clone, &price));
+	ASSERT_DOUBLE_EQUALS(price, 18 + 5);
+	dishDestroy(clone);
+	dishDestroy(dish);
+
+	return true;
+}
+
+static bool testAddValidIngredients() {
+	ValidIngredient meaty, milky, parve;
+	ASSERT_EQUALS(ingredientInitializeValid("Steak", MEATY, 1, 1, 1, &meaty),
+				INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(ingredientInitializeValid("Cheese", MILKY, 1, 1, 2, &milky),
+				INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(ingredientInitializeValid("Salt", PARVE, 1, 1, 4, &parve),
+				INGREDIENT_SUCCESS);
+	ValidIngredient batch[] = { parve, meaty, parve };
+
+	Dish dish = dishCreateWithFlags("Stew", "Chef", 5, DISH_INDEX_NAMES);
+	ASSERT_NULL_ARGUMENT(dishAddValidIngredient(NULL, parve));
+	ASSERT_NULL_ARGUMENT(dishAddValidIngredients(NULL, batch, 3));
+	ASSERT_NULL_ARGUMENT(dishAddValidIngredients(dish, NULL, 3));
+	ASSERT_SUCCESS(dishAddValidIngredients(dish, NULL, 0));
+
+	ASSERT_SUCCESS(dishAddValidIngredient(dish, meaty));
+	ASSERT_KOSHER_VIOLATION(dishAddValidIngredient(dish, milky));
+	ASSERT_SUCCESS(dishAddValidIngredients(dish, batch, 3));
+	ASSERT_FULL(dishAddValidIngredients(dish, batch, 2));
+	ASSERT_EQUALS(dish->currentIngredients, 4);
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[2]), "Steak");
+	double price;
+	ASSERT_SUCCESS(dishGetPrice(dish, &price));
+	ASSERT_DOUBLE_EQUALS(price, 10);
+
+	/* a clone shares the ingredients it was made from */
+	Dish clone = dishClone(dish);
+	ASSERT_SUCCESS(dishAddValidIngredient(clone, parve));
+	ASSERT_EQUALS(clone->currentIngredients, 5);
+	ASSERT_EQUALS(dish->currentIngredients, 4);
+	ASSERT_SUCCESS(dishGetPrice(clone, &price));
+	ASSERT_DOUBLE_EQUALS(price, 14);
+	dishDestroy(clone);
+	dishTaste(dish, true);
+	ASSERT_ALREADY_TASTED(dishAddValidIngredient(dish, parve));
+	dishDestroy(dish);
+
+	return true;
+}
+
+static bool testGrowingStorage() {
+	Dish dish = dishCreate("Buffet", "Everyone", 1 << 30);
+	ASSERT_NOT_NULL(dish);
+	ASSERT_TRUE(dish->storage->capacity < 1000);
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	for (int i = 0; i < 1000; i++) {
+		sprintf(name, "Dish %d", i);
+		Ingredient ing = ingredientInitialize(name, PARVE, i, 1, 1, NULL);
+		ASSERT_SUCCESS(dishAddIngredient(dish, ing));
+	}
+	ASSERT_TRUE(dish->storage->capacity < 2000);
+	for (int i = 0; i < 1000; i++) {
+		ASSERT_EQUALS(dish->ingredients[i].calories, i);
+	}
+
+	Dish clone = dishClone(dish);
+	ASSERT_NOT_NULL(clone);
+	ASSERT_SUCCESS(dishRemoveIngredient(clone, 0));
+	ASSERT_EQUALS(clone->ingredients[0].calories, 1);
+	ASSERT_EQUALS(dish->ingredients[0].calories, 0);
+	dishDestroy(clone);
+	dishDestroy(dish);
+
+	dish = dishCreate("Small", "Cook", 5);
+	Ingredient ing = ingredientInitialize("Salt", PARVE, 1, 1, 1, NULL);
+	for (int i = 0; i < 5; i++) {
+		ASSERT_SUCCESS(dishAddIngredient(dish, ing));
+	}
+	ASSERT_EQUALS(dish->storage->capacity, 5);
+	ASSERT_FULL(dishAddIngredient(dish, ing));
+	dishDestroy(dish);
+
+	return true;
+}
+
+static bool testGetAllowedKosherTypes() {
+
+	Dish dish = dishCreate("Cheeseburger", "Lo Kasher", 3);
+	Ingredient meat = ingredientInitialize("Burger", MEATY, 1, 1, 1, NULL);
+	bool allowed[INGREDIENT_KOSHER_TYPE_VALUES];
+
+	ASSERT_NULL_ARGUMENT(dishGetAllowedKosherTypes(NULL, allowed));
+	ASSERT_NULL_ARGUMENT(dishGetAllowedKosherTypes(dish, NULL));
+
+	ASSERT_SUCCESS(dishGetAllowedKosherTypes(dish, allowed));
+	ASSERT_TRUE(allowed[MEATY] && allowed[MILKY] && allowed[PARVE]);
+
+	dishAddIngredient(dish, meat);
+	ASSERT_SUCCESS(dishGetAllowedKosherTypes(dish, allowed));
+	ASSERT_TRUE(allowed[MEATY]);
+	ASSERT_FALSE(allowed[MILKY]);
+	ASSERT_TRUE(allowed[PARVE]);
+
+	dishDestroy(dish);
+	return true;
+}
+
+static bool testIngredientRecords() {
+
+	Dish dish = dishCreate("Shakshuka", "Dr. Shakshuka", 3);
+	IngredientRecordNames names = ingredientRecordNamesCreate();
+	Ingredient egg = ingredientInitialize("Egg", PARVE, 70, 6, 1.5, NULL);
+	Ingredient cheese = ingredientInitialize("Feta", MILKY, 260, 4, 8, NULL);
+	Ingredient meat = ingredientInitialize("Merguez", MEATY, 300, 2, 12, NULL);
+	IngredientRecord records[3];
+
+	ASSERT_EQUALS(ingredientRecordPack(names, egg, &records[0]),
+				INGREDIENT_RECORD_SUCCESS);
+	ASSERT_EQUALS(ingredientRecordPack(names, cheese, &records[1]),
+				INGREDIENT_RECORD_SUCCESS);
+	ASSERT_EQUALS(ingredientRecordPack(names, meat, &records[2]),
+				INGREDIENT_RECORD_SUCCESS);
+
+	ASSERT_NULL_ARGUMENT(dishAddIngredientRecord(NULL, names, records[0]));
+	ASSERT_SUCCESS(dishAddIngredientRecord(dish, names, records[0]));
+	ASSERT_SUCCESS(dishAddIngredientRecord(dish, names, records[1]));
+	ASSERT_KOSHER_VIOLATION(dishAddIngredientRecord(dish, names, records[2]));
+	IngredientRecord bad = records[0];
+	bad.name = (uint32_t)-1;
+	ASSERT_EQUALS(dishAddIngredientRecord(dish, names, bad),
+				DISH_BAD_INGREDIENT);
+	bad = records[0];
+	bad.attributes |= (uint32_t)3 << (INGREDIENT_RECORD_CALORIES_BITS +
+									INGREDIENT_RECORD_HEALTH_BITS);
+	ASSERT_EQUALS(dishAddIngredientRecord(dish, names, bad),
+				DISH_BAD_INGREDIENT);
+	ASSERT_EQUALS(dish->currentIngredients, 2);
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[1]), "Feta");
+	ASSERT_EQUALS(dish->ingredients[1].calories, 260);
+
+	IngredientRecord packed[3];
+	ASSERT_NULL_ARGUMENT(dishGetIngredientRecords(dish, names, NULL));
+	ASSERT_SUCCESS(dishGetIngredientRecords(dish, names, packed));
+	for (int i=0;i<2;i++) {
+		ASSERT_EQUALS(packed[i].name, records[i].name);
+		ASSERT_EQUALS(packed[i].attributes, records[i].attributes);
+		ASSERT_DOUBLE_EQUALS(packed[i].cost, records[i].cost);
+	}
+#ifdef INGREDIENT_INTERNED_NAMES
+	ASSERT_SUCCESS(dishGetIngredientRecords(dish, NULL, packed));
+	ASSERT_EQUALS(packed[1].name, cheese.name.id);
+#else
+	ASSERT_NULL_ARGUMENT(dishGetIngredientRecords(dish, NULL, packed));
+#endif
+
+	ingredientRecordNamesDestroy(names);
+	dishDestroy(dish);
 	return true;
 }
 
@@ -172,10 +448,98 @@ static bool testRemoveIngredient() {
 	dishTaste(dish,true);
 	ASSERT_ALREADY_TASTED(dishRemoveIngredient(dish,0));
 
+	dishDestroy(dish);
+
+	dish = dishCreate("Shlosha Ahim", "Ima", 3);
+	Ingredient ing2 = ingredientInitialize("Ah Gadol", PARVE, 1, 1, 1, NULL);
+	Ingredient ing3 = ingredientInitialize("Ah Katan", PARVE, 1, 1, 1, NULL);
+	dishAddIngredient(dish, ing1);
+	dishAddIngredient(dish, ing2);
+	dishAddIngredient(dish, ing3);
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 0));
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[0]), "Ah Gadol");
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[1]), "Ah Katan");
+
+	dishDestroy(dish);
+	return true;
+}
+
+static bool testUnorderedRemove() {
+	Dish dish = dishCreateWithFlags("Salad", "Chef", 4,
+									DISH_UNORDERED | DISH_INDEX_NAMES);
+	Ingredient ing1 = ingredientInitialize("Tomato", PARVE, 10, 1, 1, NULL);
+	Ingredient ing2 = ingredientInitialize("Cucumber", PARVE, 20, 1, 2, NULL);
+	Ingredient ing3 = ingredientInitialize("Onion", PARVE, 30, 1, 3, NULL);
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing1));
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing2));
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing3));
+
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 0));
+	ASSERT_EQUALS(dish->currentIngredients, 2);
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[0]), "Onion");
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[1]), "Cucumber");
+	double price;
+	ASSERT_SUCCESS(dishGetPrice(dish, &price));
+	ASSERT_DOUBLE_EQUALS(price, 5);
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 1));
+	ASSERT_STRING_EQUALS(ingredientPeekName(&dish->ingredients[0]), "Onion");
+	ASSERT_SUCCESS(dishAddIngredient(dish, ing3));
+	bool isDuplicate;
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish, &isDuplicate));
+	ASSERT_TRUE(isDuplicate);
+
 	dishDestroy(dish);
 	return true;
 }
 
+static bool testRemoveIngredients() {
+	const char* names[] = { "A", "B", "C", "D", "E", "F" };
+	int indexes[] = { 4, 1, 4, 0 };
+	int badIndexes[] = { 1, 6 };
+	Dish dishes[2];
+	dishes[0] = dishCreate("Ordered", "Chef", 6);
+	dishes[1] = dishCreateWithFlags("Unordered", "Chef", 6, DISH_UNORDERED);
+	for (int d = 0; d < 2; d++) {
+		for (int i = 0; i < 6; i++) {
+			Ingredient ing = ingredientInitialize(names[i], PARVE, i, 1, i,
+												NULL);
+			ASSERT_SUCCESS(dishAddIngredient(dishes[d], ing));
+		}
+		ASSERT_NULL_ARGUMENT(dishRemoveIngredients(NULL, indexes, 4));
+		ASSERT_NULL_ARGUMENT(dishRemoveIngredients(dishes[d], NULL, 4));
+		ASSERT_SUCCESS(dishRemoveIngredients(dishes[d], NULL, 0));
+		ASSERT_INGREDIENT_NOT_FOUND(dishRemoveIngredients(dishes[d],
+														badIndexes, 2));
+		ASSERT_EQUALS(dishes[d]->currentIngredients, 6);
+		ASSERT_SUCCESS(dishRemoveIngredients(dishes[d], indexes, 4));
+		ASSERT_EQUALS(dishes[d]->currentIngredients, 3);
+		double price;
+		ASSERT_SUCCESS(dishGetPrice(dishes[d], &price));
+		ASSERT_DOUBLE_EQUALS(price, 2 + 3 + 5);
+	}
+	const char* ordered[] = { "C", "D", "F" };
+	const char* unordered[] = { "D", "F", "C" };
+	for (int i = 0; i < 3; i++) {
+		ASSERT_STRING_EQUALS(ingredientPeekName(&dishes[0]->ingredients[i]),
+							ordered[i]);
+		ASSERT_STRING_EQUALS(ingredientPeekName(&dishes[1]->ingredients[i]),
+							unordered[i]);
+	}
+
+	int all[] = { 0, 1, 2 };
+	dishTaste(dishes[0], true);
+	ASSERT_ALREADY_TASTED(dishRemoveIngredients(dishes[0], all, 3));
+	Dish clone = dishClone(dishes[1]);
+	ASSERT_SUCCESS(dishRemoveIngredients(clone, all, 3));
+	ASSERT_EQUALS(clone->currentIngredients, 0);
+	ASSERT_EQUALS(dishes[1]->currentIngredients, 3);
+
+	dishDestroy(clone);
+	dishDestroy(dishes[0]);
+	dishDestroy(dishes[1]);
+	return true;
+}
+
 static bool testGetName() {
 
 
@@ -222,6 +586,52 @@ static bool testGetCook() {
 }
 
 
+static bool testPeekName() {
+
+	Dish dish = dishCreate("Ktzitzot", "Savta", 2);
+	const char* name;
+	const char* cook;
+
+	ASSERT_NULL_ARGUMENT(dishPeekName(NULL,&name));
+	ASSERT_NULL_ARGUMENT(dishPeekName(dish,NULL));
+	ASSERT_NULL_ARGUMENT(dishPeekCook(NULL,&cook));
+	ASSERT_NULL_ARGUMENT(dishPeekCook(dish,NULL));
+
+	ASSERT_SUCCESS(dishPeekName(dish, &name));
+	ASSERT_STRING_EQUALS(name, "Ktzitzot");
+	ASSERT_SUCCESS(dishPeekCook(dish, &cook));
+	ASSERT_STRING_EQUALS(cook, "Savta");
+
+	dishSetName(dish, "Ktzitzot Dagim");
+	ASSERT_SUCCESS(dishPeekName(dish, &name));
+	ASSERT_STRING_EQUALS(name, "Ktzitzot Dagim");
+
+	dishDestroy(dish);
+	return true;
+}
+
+
+static bool testCopyName() {
+
+	Dish dish = dishCreate("Shnitzel", "Aba", 2);
+	char buffer[10];
+
+	ASSERT_NULL_ARGUMENT(dishCopyName(NULL,buffer,10));
+	ASSERT_NULL_ARGUMENT(dishCopyName(dish,NULL,10));
+	ASSERT_NULL_ARGUMENT(dishCopyCook(dish,NULL,10));
+
+	ASSERT_EQUALS(dishCopyName(dish,buffer,8), DISH_SMALL_BUFFER);
+	ASSERT_EQUALS(dishCopyName(dish,buffer,-1), DISH_SMALL_BUFFER);
+	ASSERT_SUCCESS(dishCopyName(dish,buffer,9));
+	ASSERT_STRING_EQUALS(buffer, "Shnitzel");
+	ASSERT_SUCCESS(dishCopyCook(dish,buffer,10));
+	ASSERT_STRING_EQUALS(buffer, "Aba");
+
+	dishDestroy(dish);
+	return true;
+}
+
+
 static bool testSetName() {
 
 	Dish dish = dishCreate("Sweet & Sour Dor", "Ofer Givoli", 2);
@@ -244,6 +654,17 @@ static bool testSetName() {
 	ASSERT_STRING_EQUALS(name, "New Blabla");
 	free(name);
 
+	ASSERT_SUCCESS(dishSetName(dish, "A name much longer than the original one"));
+	ASSERT_SUCCESS(dishSetName(dish, "Short"));
+	dishGetName(dish, &name);
+	ASSERT_STRING_EQUALS(name, "Short");
+	free(name);
+
+	char* cook;
+	dishGetCook(dish, &cook);
+	ASSERT_STRING_EQUALS(cook, "Ofer Givoli");
+	free(cook);
+
 	dishDestroy(dish);
 	return true;
 }
@@ -277,6 +698,27 @@ static bool testAreDuplicateIngredients() {
 	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish2, &isDuplicate));
 	ASSERT_FALSE(isDuplicate);
 
+	dishDestroy(dish1);
+	dishDestroy(dish2);
+
+	dish1 = dishCreateWithFlags("Indexed Code", "Myself", 5, DISH_INDEX_NAMES);
+	ASSERT_EMPTY(dishAreDuplicateIngredients(dish1,&isDuplicate));
+	dishAddIngredient(dish1, ing1);
+	dishAddIngredient(dish1, ing3);
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish1, &isDuplicate));
+	ASSERT_FALSE(isDuplicate);
+	dishAddIngredient(dish1, ing2);
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish1, &isDuplicate));
+	ASSERT_TRUE(isDuplicate);
+
+	dish2 = dishClone(dish1);
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish2, &isDuplicate));
+	ASSERT_TRUE(isDuplicate);
+
+	ASSERT_SUCCESS(dishRemoveIngredient(dish1, 0));
+	ASSERT_SUCCESS(dishAreDuplicateIngredients(dish1, &isDuplicate));
+	ASSERT_FALSE(isDuplicate);
+
 	dishDestroy(dish1);
 	dishDestroy(dish2);
 	return true;
@@ -295,6 +737,46 @@ static bool testTaste() {
 }
 
 
+#define TASTING_THREADS 4
+#define TASTINGS_PER_THREAD 100000
+
+static void* tasteManyTimes(void* dish) {
+	for (int i = 0; i < TASTINGS_PER_THREAD; i++) {
+		dishTaste((Dish)dish, i % 4 == 0);
+	}
+	return NULL;
+}
+
+static bool testConcurrentTaste() {
+
+	Dish dish = dishCreateWithFlags("Sir Shel Osher", "Kulam", 1,
+									DISH_CONCURRENT_TASTING);
+	pthread_t judges[TASTING_THREADS];
+	double tastiness;
+
+	for (int i = 0; i < TASTING_THREADS; i++) {
+		ASSERT_EQUALS(pthread_create(&judges[i], NULL, tasteManyTimes, dish), 0);
+	}
+	for (int i = 0; i < 1000; i++) {
+		if (dishHowMuchTasty(dish, &tastiness) == DISH_SUCCESS &&
+				(tastiness < 0 || tastiness > 1)) {
+			ASSERT(false);
+		}
+	}
+	for (int i = 0; i < TASTING_THREADS; i++) {
+		pthread_join(judges[i], NULL);
+	}
+
+	ASSERT_EQUALS(dish->tastings >> DISH_TASTINGS_SHIFT,
+					TASTING_THREADS * TASTINGS_PER_THREAD);
+	ASSERT_SUCCESS(dishHowMuchTasty(dish, &tastiness));
+	ASSERT_DOUBLE_EQUALS(tastiness, 0.25);
+
+	dishDestroy(dish);
+	return true;
+}
+
+
 static bool testHowMuchTasty() {
 
 	Dish dish = dishCreate("Tasty", "Me of course", 1);
@@ -355,6 +837,75 @@ static bool testGetQuality() {
 }
 
 
+static bool testGetPrice() {
+
+	Dish dish = dishCreate("Yakar", "Yoter Midai", 3);
+	Ingredient ing1 = ingredientInitialize("Kaviar", PARVE, 10, 5, 100.5, NULL);
+	Ingredient ing2 = ingredientInitialize("Lehem", PARVE, 200, 3, 2, NULL);
+	double price;
+
+	ASSERT_NULL_ARGUMENT(dishGetPrice(NULL,&price));
+	ASSERT_NULL_ARGUMENT(dishGetPrice(dish,NULL));
+
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_DOUBLE_EQUALS(price, 0);
+
+	dishAddIngredient(dish, ing1);
+	dishAddIngredient(dish, ing2);
+	dishAddIngredient(dish, ing2);
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_DOUBLE_EQUALS(price, 104.5);
+
+	int64_t micros;
+	ASSERT_NULL_ARGUMENT(dishGetPriceMicros(NULL,&micros));
+	ASSERT_NULL_ARGUMENT(dishGetPriceMicros(dish,NULL));
+	ASSERT_SUCCESS(dishGetPriceMicros(dish,&micros));
+	ASSERT_EQUALS(micros, 104500000);
+
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 0));
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_DOUBLE_EQUALS(price, 4);
+
+	dishRemoveIngredient(dish, 0);
+	dishRemoveIngredient(dish, 0);
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_EQUALS(price, 0);
+
+	/* removing a large cost must not take the small ones with it */
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	double largeCost = 9e9;
+#else
+	double largeCost = 1e16;
+#endif
+	Ingredient large = ingredientInitialize("Zahav", PARVE, 10, 5, largeCost,
+											NULL);
+	Ingredient small = ingredientInitialize("Melah", PARVE, 10, 5, 1, NULL);
+	ASSERT_SUCCESS(dishAddIngredient(dish, large));
+	ASSERT_SUCCESS(dishAddIngredient(dish, small));
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 0));
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_EQUALS(price, 1);
+	ASSERT_SUCCESS(dishAddIngredient(dish, large));
+	ASSERT_SUCCESS(dishAddIngredient(dish, small));
+	int largeIndex = 1;
+	ASSERT_SUCCESS(dishRemoveIngredients(dish, &largeIndex, 1));
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_EQUALS(price, 2);
+
+	dishDestroy(dish);
+
+	dish = dishCreateWithFlags("Kova", "Chef", 3, DISH_UNORDERED);
+	ASSERT_SUCCESS(dishAddIngredient(dish, small));
+	ASSERT_SUCCESS(dishAddIngredient(dish, large));
+	ASSERT_SUCCESS(dishAddIngredient(dish, small));
+	ASSERT_SUCCESS(dishRemoveIngredient(dish, 1));
+	ASSERT_SUCCESS(dishGetPrice(dish,&price));
+	ASSERT_EQUALS(price, 2);
+	dishDestroy(dish);
+	return true;
+}
+
+
 static bool testIsBetter() {
 
 	Dish dish1 = dishCreate("Reva Shaa", "Mehake Barehov", 2);
@@ -408,14 +959,25 @@ int main() {
 	RUN_TEST(testDestroy);
 	RUN_TEST(testClone);
 	RUN_TEST(testAddIngredient);
+	RUN_TEST(testAddIngredients);
+	RUN_TEST(testAddValidIngredients);
+	RUN_TEST(testGrowingStorage);
+	RUN_TEST(testGetAllowedKosherTypes);
+	RUN_TEST(testIngredientRecords);
 	RUN_TEST(testRemoveIngredient);
+	RUN_TEST(testUnorderedRemove);
+	RUN_TEST(testRemoveIngredients);
 	RUN_TEST(testGetName);
 	RUN_TEST(testGetCook);
+	RUN_TEST(testPeekName);
+	RUN_TEST(testCopyName);
 	RUN_TEST(testSetName);
 	RUN_TEST(testAreDuplicateIngredients);
 	RUN_TEST(testTaste);
 	RUN_TEST(testHowMuchTasty);
+	RUN_TEST(testConcurrentTaste);
 	RUN_TEST(testGetQuality);
+	RUN_TEST(testGetPrice);
 	RUN_TEST(testIsBetter);
 
 	return 0;
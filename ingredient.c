@@ -2,6 +2,7 @@
 #include <string.h>
 #include <math.h>
 #include <stdbool.h>
+#include <pthread.h>
 #include "ingredient.h"
 
 //IN_RANGE macro is not limited to a certain type
@@ -11,6 +12,21 @@
 #define  CHECK_NULL_ARG(val) \
 	if (val == NULL) {	return INGREDIENT_NULL_ARGUMENT;	}
 
+/* Fewer rows than this per thread cost more to hand out than to fill. */
+#define BATCH_MIN_ROWS_PER_THREAD 4096
+
+/* The rows of a batch one thread initializes. */
+typedef struct {
+	const char* const* names;
+	const KosherType* kosherTypes;
+	const int* calories;
+	const int* health;
+	const double* costs;
+	int count;
+	Ingredient* ingredients;
+	IngredientResult* results;
+} BatchSlice;
+
 /******************************************************************************
  * static internal functions
  *****************************************************************************/
@@ -37,13 +53,87 @@ static bool isValidHealth(int health) {
 
 static bool isValidCost(double cost) {
 	double const INGREDIENT_MIN_COST = 0.0;
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	if (isfinite(cost) && cost*INGREDIENT_COST_MICROS_PER_UNIT >
+							(double)INGREDIENT_MAX_COST_MICROS) {
+		return false;
+	}
+#endif
 	return (isfinite(cost) && cost >= INGREDIENT_MIN_COST);
 }
 
+static int64_t costToMicros(double cost) {
+	return llround(cost*INGREDIENT_COST_MICROS_PER_UNIT);
+}
+
 static bool isValidDiscount(double discount) {
 	return IN_RANGE(discount,0,100);
 }
 
+/*
+ * Places @cost after @discount in @discounted, leaving it unchanged on error.
+ */
+static IngredientResult discountCost(double cost, int discount,
+									double* discounted) {
+	if (!isValidCost(cost)) {
+		return INGREDIENT_BAD_COST;
+	}
+	if (!isValidDiscount(discount)) {
+		return INGREDIENT_BAD_DISCOUNT;
+	}
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	int64_t const PERCENT = 100;
+	int64_t micros = costToMicros(cost)*(PERCENT-discount);
+	*discounted = ingredientCostFromMicros((micros+PERCENT/2)/PERCENT);
+#else
+	*discounted = cost*(1-(discount*0.01));
+#endif
+	return INGREDIENT_SUCCESS;
+}
+
+/*
+ * The quality formula. computeQuality evaluates it for values out of range,
+ * and fillQualityTable evaluates it once for every valid pair.
+ */
+#define CALORIE_RANGE (INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES)
+#define HEALTH_RANGE (INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH)
+
+#if CALORIE_RANGE == 0
+#define QUALITY_OF(calories, health) ((double)INGREDIENT_BAD_CALORIES)
+#elif HEALTH_RANGE == 0
+#define QUALITY_OF(calories, health) ((double)INGREDIENT_BAD_HEALTH)
+#else
+#define QUALITY_OF(calories, health) \
+	((health)*(10.0/HEALTH_RANGE)-(calories)*(10.0/CALORIE_RANGE) > 0 ? \
+		(health)*(10.0/HEALTH_RANGE)-(calories)*(10.0/CALORIE_RANGE) : 0)
+#endif
+
+static double computeQuality(int calories, int health) {
+	return QUALITY_OF(calories,health);
+}
+
+#define QUALITY_TABLE_SIZE ((CALORIE_RANGE+1)*INGREDIENT_HEALTH_VALUES)
+
+static double qualityTable[QUALITY_TABLE_SIZE];
+
+const double* const ingredientQualityTable = qualityTable;
+
+/*
+ * Runs once before main (constructor is a compiler extension, as the
+ * __atomic builtins are), so the table follows the defines in ingredient.h
+ * at any size and is never written once other code can read it.
+ */
+__attribute__((constructor)) static void fillQualityTable(void) {
+	for (int calories=INGREDIENT_MIN_CALORIES;
+			calories<=INGREDIENT_MAX_CALORIES;calories++) {
+		for (int health=INGREDIENT_MIN_HEALTH;health<=INGREDIENT_MAX_HEALTH;
+				health++) {
+			qualityTable[INGREDIENT_QUALITY_INDEX(calories,health)] =
+					computeQuality(calories,health);
+		}
+	}
+}
+
 static IngredientResult checkInputForInitialize(const char* name, KosherType 
 	kosherType, int calories, int health, double cost) {
 
@@ -67,6 +157,50 @@ static IngredientResult checkInputForInitialize(const char* name, KosherType
 	return INGREDIENT_SUCCESS;
 }
 
+/*
+ * Range checks for a whole batch. The loop has no branches, so the compiler
+ * can vectorize it. The checks run from the last error ingredientInitialize
+ * reports to the first, so each row ends up with the code
+ * ingredientInitialize would give it, names aside.
+ */
+static void checkRangesForBatch(const KosherType* kosherTypes,
+	const int* calories, const int* health, const double* costs, int count,
+	IngredientResult* results) {
+	for (int i=0;i<count;i++) {
+		IngredientResult result = INGREDIENT_SUCCESS;
+		result = isValidCost(costs[i]) ? result : INGREDIENT_BAD_COST;
+		result = isValidHealth(health[i]) ? result : INGREDIENT_BAD_HEALTH;
+		result = isValidCalories(calories[i]) ? result : INGREDIENT_BAD_CALORIES;
+		result = isValidKosherType(kosherTypes[i]) ? result :
+												INGREDIENT_BAD_KOSHER_TYPE;
+		results[i] = result;
+	}
+}
+
+/*
+ * Fills an ingredient from already validated values.
+ */
+static IngredientResult fillIngredient(Ingredient* ingredient,
+	const char* name, KosherType kosherType, int calories, int health,
+	double cost) {
+#ifdef INGREDIENT_INTERNED_NAMES
+	if(namePoolIntern(name, &ingredient->name) != NAME_POOL_SUCCESS) {
+		return INGREDIENT_OUT_OF_MEMORY;
+	}
+#else
+	strcpy(ingredient->name, name);
+#endif
+	ingredient->kosherType = kosherType;
+	ingredient->calories = calories;
+	ingredient->health = health;
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+	ingredient->cost = ingredientCostFromMicros(costToMicros(cost));
+#else
+	ingredient->cost = cost;
+#endif
+	return INGREDIENT_SUCCESS;
+}
+
 /******************************************************************************
  * interface functions
  *****************************************************************************/
@@ -78,65 +212,221 @@ Ingredient ingredientInitialize(const char* name, KosherType kosherType,
 	IngredientResult tempResult;
 	tempResult = checkInputForInitialize(name, kosherType, 
 		calories, health, cost);
+	if(tempResult == INGREDIENT_SUCCESS) {
+		tempResult = fillIngredient(&newIngredient, name, kosherType,
+			calories, health, cost);
+	}
 	if(result != NULL) {
 		*result = tempResult;
 	}
-	if(tempResult != INGREDIENT_SUCCESS) {
-		return newIngredient;
+	return newIngredient;
+}
+
+IngredientResult ingredientInitializeBatch(const char* const* names,
+	const KosherType* kosherTypes, const int* calories, const int* health,
+	const double* costs, int count, Ingredient* ingredients,
+	IngredientResult* results) {
+	 CHECK_NULL_ARG(names)
+	 CHECK_NULL_ARG(kosherTypes)
+	 CHECK_NULL_ARG(calories)
+	 CHECK_NULL_ARG(health)
+	 CHECK_NULL_ARG(costs)
+	 CHECK_NULL_ARG(ingredients)
+	 CHECK_NULL_ARG(results)
+
+	checkRangesForBatch(kosherTypes, calories, health, costs, count, results);
+	for (int i=0;i<count;i++) {
+		if (names[i] == NULL) {
+			results[i] = INGREDIENT_NULL_ARGUMENT;
+		} else if (!isValidName(names[i])) {
+			results[i] = INGREDIENT_BAD_NAME;
+		} else if (results[i] == INGREDIENT_SUCCESS) {
+			results[i] = fillIngredient(ingredients+i, names[i], kosherTypes[i],
+				calories[i], health[i], costs[i]);
+		}
 	}
-	
-	strcpy(newIngredient.name, name);
-	newIngredient.kosherType = kosherType;
-	newIngredient.calories = calories;
-	newIngredient.health = health;
-	newIngredient.cost = cost;
+	return INGREDIENT_SUCCESS;
+}
 
-	return newIngredient;
+static void* initializeSliceThread(void* argument) {
+	BatchSlice* slice = (BatchSlice*)argument;
+	ingredientInitializeBatch(slice->names,slice->kosherTypes,slice->calories,
+		slice->health,slice->costs,slice->count,slice->ingredients,
+		slice->results);
+	return NULL;
+}
+
+IngredientResult ingredientInitializeBatchParallel(const char* const* names,
+	const KosherType* kosherTypes, const int* calories, const int* health,
+	const double* costs, int count, int threads, Ingredient* ingredients,
+	IngredientResult* results) {
+	 CHECK_NULL_ARG(names)
+	 CHECK_NULL_ARG(kosherTypes)
+	 CHECK_NULL_ARG(calories)
+	 CHECK_NULL_ARG(health)
+	 CHECK_NULL_ARG(costs)
+	 CHECK_NULL_ARG(ingredients)
+	 CHECK_NULL_ARG(results)
+
+#ifdef INGREDIENT_INTERNED_NAMES
+	threads = 1;
+#endif
+	if (threads > count/BATCH_MIN_ROWS_PER_THREAD) {
+		threads = count/BATCH_MIN_ROWS_PER_THREAD;
+	}
+	if (threads <= 1) {
+		return ingredientInitializeBatch(names,kosherTypes,calories,health,
+										costs,count,ingredients,results);
+	}
+	BatchSlice* slices = (BatchSlice*)malloc(sizeof(BatchSlice)*threads);
+	pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t)*threads);
+	bool* started = (bool*)malloc(sizeof(bool)*threads);
+	if (slices == NULL || ids == NULL || started == NULL) {
+		free(slices);
+		free(ids);
+		free(started);
+		return INGREDIENT_OUT_OF_MEMORY;
+	}
+	for (int i=0;i<threads;i++) {
+		int first = (int)((int64_t)count*i/threads);
+		slices[i].names = names+first;
+		slices[i].kosherTypes = kosherTypes+first;
+		slices[i].calories = calories+first;
+		slices[i].health = health+first;
+		slices[i].costs = costs+first;
+		slices[i].count = (int)((int64_t)count*(i+1)/threads)-first;
+		slices[i].ingredients = ingredients+first;
+		slices[i].results = results+first;
+		started[i] = (i > 0 && pthread_create(&ids[i],NULL,
+							initializeSliceThread,&slices[i]) == 0);
+	}
+	for (int i=0;i<threads;i++) {
+		if (!started[i]) {
+			initializeSliceThread(&slices[i]);
+		}
+	}
+	for (int i=0;i<threads;i++) {
+		if (started[i]) {
+			pthread_join(ids[i],NULL);
+		}
+	}
+	free(slices);
+	free(ids);
+	free(started);
+	return INGREDIENT_SUCCESS;
 }
 
 IngredientResult ingredientGetName(Ingredient ingredient, char* buffer, 
 	int length) {
 	 CHECK_NULL_ARG(buffer)
 	
-	if(length < 0 || strlen(ingredient.name) + 1 > length) {
+	const char* name = ingredientPeekName(&ingredient);
+	if(name == NULL) {
+		return INGREDIENT_BAD_NAME;
+	}
+	if(length < 0 || strlen(name) + 1 > length) {
 		return INGREDIENT_SMALL_BUFFER;
 	}
 
-	strcpy(buffer,ingredient.name);
+	strcpy(buffer,name);
 	return INGREDIENT_SUCCESS;
 }
 
+IngredientResult ingredientValidate(Ingredient ingredient) {
+#ifndef INGREDIENT_INTERNED_NAMES
+	if (memchr(ingredient.name,'\0',sizeof(ingredient.name)) == NULL) {
+		return INGREDIENT_BAD_NAME;
+	}
+#endif
+	const char* name = ingredientPeekName(&ingredient);
+	if (name == NULL) {
+		return INGREDIENT_BAD_NAME;
+	}
+	return checkInputForInitialize(name, ingredient.kosherType,
+		ingredient.calories, ingredient.health, ingredient.cost);
+}
+
+IngredientResult ingredientInitializeValid(const char* name,
+		KosherType kosherType, int calories, int health, double cost,
+		ValidIngredient* ingredient) {
+	CHECK_NULL_ARG(ingredient)
+	IngredientResult result;
+	Ingredient initialized = ingredientInitialize(name, kosherType, calories,
+												health, cost, &result);
+	if (result == INGREDIENT_SUCCESS) {
+		ingredient->ingredient = initialized;
+	}
+	return result;
+}
+
+IngredientResult ingredientToValid(Ingredient ingredient,
+		ValidIngredient* valid) {
+	CHECK_NULL_ARG(valid)
+	IngredientResult result = ingredientValidate(ingredient);
+	if (result == INGREDIENT_SUCCESS) {
+		valid->ingredient = ingredient;
+	}
+	return result;
+}
+
+const char* ingredientPeekName(const Ingredient* ingredient) {
+	if (ingredient == NULL) {
+		return NULL;
+	}
+#ifdef INGREDIENT_INTERNED_NAMES
+	return namePoolGet(ingredient->name);
+#else
+	return ingredient->name;
+#endif
+}
+
+bool ingredientHaveSameName(Ingredient ingredient1, Ingredient ingredient2) {
+#ifdef INGREDIENT_INTERNED_NAMES
+	return namePoolAreEqual(ingredient1.name, ingredient2.name);
+#else
+	return strcmp(ingredient1.name, ingredient2.name) == 0;
+#endif
+}
+
 IngredientResult ingredientChangeCost(Ingredient* ingredient,
 										double cost, int discount)	{
 	 CHECK_NULL_ARG(ingredient)
 	
-	if (!isValidCost(cost)) {
-		return INGREDIENT_BAD_COST;
+	return discountCost(cost,discount,&ingredient->cost);
+}
+
+IngredientResult ingredientApplyDiscountBatch(Ingredient* ingredients,
+		int count, int discount, const int* discounts,
+		IngredientResult* results) {
+	if (count > 0) {
+		CHECK_NULL_ARG(ingredients)
+		CHECK_NULL_ARG(results)
 	}
-	if (!isValidDiscount(discount)) {
-		return INGREDIENT_BAD_DISCOUNT;
+	for (int i=0;i<count;i++) {
+		results[i] = discountCost(ingredients[i].cost,
+								discounts == NULL ? discount : discounts[i],
+								&ingredients[i].cost);
 	}
-	ingredient->cost = cost*(1-(discount*0.01));
 	return INGREDIENT_SUCCESS;
 }
 
-double ingredientGetQuality(Ingredient ingredient)	{
-	double calories = 0;
-	double health = 0;
-	if ((INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES) == 0) {
-		return INGREDIENT_BAD_CALORIES;
-	}
-	if ((INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH) == 0) {
-		return INGREDIENT_BAD_HEALTH;
-	}
-	int calorieRange = (INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES);
-	int healthRange = (INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH);
-	calories = ingredient.calories*(10.0/calorieRange);
-	health = ingredient.health*(10.0/healthRange);
-	if (health-calories > 0) {
-		return health-calories;
+int64_t ingredientGetCostMicros(Ingredient ingredient) {
+	return costToMicros(ingredient.cost);
+}
+
+double ingredientCostFromMicros(int64_t micros) {
+	return (double)micros/INGREDIENT_COST_MICROS_PER_UNIT;
+}
+
+double ingredientGetQualityOf(int calories, int health) {
+	if (isValidCalories(calories) && isValidHealth(health)) {
+		return qualityTable[INGREDIENT_QUALITY_INDEX(calories,health)];
 	}
-	return 0;
+	return computeQuality(calories,health);
+}
+
+double ingredientGetQuality(Ingredient ingredient)	{
+	return ingredientGetQualityOf(ingredient.calories,ingredient.health);
 }
 
 bool ingredientIsCheaper(Ingredient ingredient1, Ingredient ingredient2)	{
@@ -13,6 +13,10 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <math.h>
+#include <stdint.h>
+#ifdef INGREDIENT_INTERNED_NAMES
+#include "name_pool.h"
+#endif
 
 /*******************************************************************************
  * Defines & Enums
@@ -36,17 +40,53 @@ typedef enum {
 
 #define DOUBLE_EQUALS(a,b) (fabs((a) - (b)) <= 1e-6)
 
+/*
+ * Costs can be expressed as whole micro-units, which ingredientGetCostMicros
+ * and ingredientCostFromMicros convert to and from.
+ * When built with INGREDIENT_FIXED_POINT_COSTS, every cost is rounded to a
+ * whole number of micro-units when it is set, and discounts are applied to
+ * the micro-units in integer arithmetic. Costs above
+ * INGREDIENT_MAX_COST_MICROS micro-units are then rejected, so that every
+ * stored cost converts to and from micro-units exactly.
+ */
+#define INGREDIENT_COST_MICROS_PER_UNIT 1000000
+#define INGREDIENT_MAX_COST_MICROS (INT64_C(1) << 53)
+
 /*******************************************************************************
  * Ingredient Struct
  ******************************************************************************/
+/*
+ * By default every ingredient holds its own copy of its name.
+ * When built with INGREDIENT_INTERNED_NAMES, names are interned in the global
+ * name pool (see name_pool.h) and an ingredient only holds an 8 byte handle
+ * to its name. Use ingredientPeekName and ingredientHaveSameName rather than
+ * the name field, so the code works in both modes.
+ */
+#ifdef INGREDIENT_INTERNED_NAMES
+typedef PooledName IngredientName;
+#else
+typedef char IngredientName[INGREDIENT_MAX_NAME_LENGTH + 1];
+#endif
+
 typedef struct ingredient_t {
-	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	IngredientName name;
 	KosherType kosherType;
 	int calories;
 	int health;
 	double cost;
 } Ingredient;
 
+/*
+ * An ingredient that is known to be valid, as ingredientValidate defines it.
+ * Only ingredientInitializeValid, ingredientToValid, ingredientReaderNextValid
+ * and ingredientCatalogGet make one, so functions that take a ValidIngredient
+ * copy it as is instead of checking it again. The ingredient may be read
+ * through the member, but must not be changed.
+ */
+typedef struct valid_ingredient_t {
+	Ingredient ingredient;
+} ValidIngredient;
+
 /*******************************************************************************
  * Return Value Definition
  ******************************************************************************/
@@ -59,7 +99,8 @@ typedef enum {
 	INGREDIENT_BAD_HEALTH,		/* An invalid health number was passed		  */
 	INGREDIENT_BAD_COST,		/* An invalid cost value was passed			  */
 	INGREDIENT_BAD_DISCOUNT,	/* An invalid discount value was passed		  */
-	INGREDIENT_SMALL_BUFFER	    /* The passed buffer is too small			  */
+	INGREDIENT_SMALL_BUFFER,    /* The passed buffer is too small			  */
+	INGREDIENT_OUT_OF_MEMORY	/* A memory error occured					  */
 } IngredientResult;
 
 /*******************************************************************************
@@ -78,6 +119,8 @@ typedef enum {
  *
  * The Success or error code of the operation will be put in result.
  * But, if the error code is of no interest to the caller, NULL can be passed.
+ * When names are interned, INGREDIENT_OUT_OF_MEMORY is placed in @result if
+ * the name couldn't be added to the name pool.
  *
  * @param name: The ingredient's name.
  * @param kosherType: The ingredient's kosherType.
@@ -90,6 +133,104 @@ typedef enum {
 Ingredient ingredientInitialize(const char* name, KosherType kosherType,
 		int calories, int health, double cost, IngredientResult* result);
 
+/*
+ * Check an ingredient that wasn't built by ingredientInitialize, such as one
+ * read from memory shared with another program.
+ * Returns the code ingredientInitialize would place in its result if it was
+ * given the ingredient's fields, or INGREDIENT_BAD_NAME if the name isn't a
+ * valid string.
+ *
+ * Ingredients built by ingredientInitialize with INGREDIENT_SUCCESS are valid,
+ * and stay valid when copied. An Ingredient's fields may still be set
+ * directly, so dishAddIngredient checks every ingredient given to it, while
+ * dishAddValidIngredient trusts a ValidIngredient and copies it as is.
+ *
+ * @param ingredient The ingredient to check.
+ * @return Success or error code.
+ */
+IngredientResult ingredientValidate(Ingredient ingredient);
+
+/*
+ * Initialize an ingredient as ingredientInitialize does, placing it in
+ * @ingredient as a ValidIngredient only if it was built successfully.
+ *
+ * @param name: The ingredient's name.
+ * @param kosherType: The ingredient's kosherType.
+ * @param calories: The ingredient's calories.
+ * @param health: The ingredient's health value.
+ * @param cost: The ingredient's cost.
+ * @param ingredient: The valid ingredient will be placed here.
+ * @return The code ingredientInitialize would place in its result, or
+ * INGREDIENT_NULL_ARGUMENT if @ingredient is NULL.
+ */
+IngredientResult ingredientInitializeValid(const char* name,
+		KosherType kosherType, int calories, int health, double cost,
+		ValidIngredient* ingredient);
+
+/*
+ * Check an ingredient with ingredientValidate, placing it in @valid only if
+ * it is valid. This is where an ingredient from outside, whose fields may
+ * have been set directly, is checked once.
+ *
+ * @param ingredient The ingredient to check.
+ * @param valid The valid ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientResult ingredientToValid(Ingredient ingredient,
+		ValidIngredient* valid);
+
+/*
+ * Initialize @count ingredients at once. Row i is built from names[i],
+ * kosherTypes[i], calories[i], health[i] and costs[i] as
+ * ingredientInitialize would build it, and is placed in ingredients[i] with
+ * its success or error code in results[i]. A row with an error doesn't stop
+ * the rows after it.
+ *
+ * The function only touches rows 0 to @count-1, so disjoint slices of the same
+ * arrays may be initialized by several threads at once. This doesn't apply
+ * when names are interned, as the name pool is shared.
+ *
+ * @param names The ingredients' names.
+ * @param kosherTypes The ingredients' kosher types.
+ * @param calories The ingredients' calories.
+ * @param health The ingredients' health values.
+ * @param costs The ingredients' costs.
+ * @param count The number of rows.
+ * @param ingredients An array of at least @count ingredients to fill.
+ * @param results An array of at least @count result codes to fill.
+ * @return INGREDIENT_NULL_ARGUMENT if one of the arrays is NULL, and
+ * INGREDIENT_SUCCESS otherwise.
+ */
+IngredientResult ingredientInitializeBatch(const char* const* names,
+		const KosherType* kosherTypes, const int* calories, const int* health,
+		const double* costs, int count, Ingredient* ingredients,
+		IngredientResult* results);
+
+/*
+ * Initialize @count ingredients as ingredientInitializeBatch does, splitting
+ * the rows into @threads slices that are initialized at the same time.
+ * Slices have at least a few thousand rows, so a small batch may use fewer
+ * threads than asked for. When names are interned the name pool is shared,
+ * so the rows are initialized by a single thread.
+ *
+ * @param names The ingredients' names.
+ * @param kosherTypes The ingredients' kosher types.
+ * @param calories The ingredients' calories.
+ * @param health The ingredients' health values.
+ * @param costs The ingredients' costs.
+ * @param count The number of rows.
+ * @param threads The number of threads to initialize with.
+ * @param ingredients An array of at least @count ingredients to fill.
+ * @param results An array of at least @count result codes to fill.
+ * @return INGREDIENT_NULL_ARGUMENT if one of the arrays is NULL,
+ * INGREDIENT_OUT_OF_MEMORY if the threads couldn't be set up, and
+ * INGREDIENT_SUCCESS otherwise.
+ */
+IngredientResult ingredientInitializeBatchParallel(const char* const* names,
+		const KosherType* kosherTypes, const int* calories, const int* health,
+		const double* costs, int count, int threads, Ingredient* ingredients,
+		IngredientResult* results);
+
 /*
  * Place the ingredient's name in the given buffer.
  *
@@ -104,6 +245,27 @@ Ingredient ingredientInitialize(const char* name, KosherType kosherType,
  */
 IngredientResult ingredientGetName(Ingredient ingredient, char* buffer, int length);
 
+/*
+ * Returns the ingredient's name without copying it.
+ * The returned string belongs to the ingredient (or to the name pool when
+ * names are interned) and must not be changed.
+ * Returns NULL if @ingredient is NULL.
+ *
+ * @param ingredient The ingredient to get it's name.
+ * @return The ingredient's name.
+ */
+const char* ingredientPeekName(const Ingredient* ingredient);
+
+/*
+ * Returns true if both ingredients have the same name.
+ * When names are interned this is a single integer compare.
+ *
+ * @param ingredient1 The first ingredient
+ * @param ingredient2 The second ingredient
+ * @return Whether the ingredients' names are equal
+ */
+bool ingredientHaveSameName(Ingredient ingredient1, Ingredient ingredient2);
+
 /*
  * Change the ingredient's cost, taking into consideration a certain discount.
  *
@@ -127,6 +289,46 @@ IngredientResult ingredientGetName(Ingredient ingredient, char* buffer, int leng
  */
 IngredientResult ingredientChangeCost(Ingredient* ingredient, double cost, int discount);
 
+/*
+ * Apply a discount to the current cost of @count ingredients at once, as
+ * ingredientChangeCost(&ingredients[i], ingredients[i].cost, discount) would.
+ * If @discounts is NULL every row gets @discount, otherwise row i gets
+ * discounts[i] and @discount is ignored. A discount of 0 leaves a row's cost
+ * as is, so a promotion on some of the rows gives the others 0.
+ *
+ * results[i] holds row i's success or error code. A row with an error keeps
+ * its cost and doesn't stop the rows after it.
+ *
+ * @param ingredients An array of at least @count ingredients to update.
+ * @param count The number of rows.
+ * @param discount The discount in percentage for every row.
+ * @param discounts The discount in percentage of each row, or NULL.
+ * @param results An array of at least @count result codes to fill.
+ * @return INGREDIENT_NULL_ARGUMENT if @ingredients or @results is NULL, and
+ * INGREDIENT_SUCCESS otherwise.
+ */
+IngredientResult ingredientApplyDiscountBatch(Ingredient* ingredients,
+		int count, int discount, const int* discounts,
+		IngredientResult* results);
+
+/*
+ * Returns the ingredient's cost in micro-units, rounded to the nearest one.
+ * When built with INGREDIENT_FIXED_POINT_COSTS no rounding is needed, so sums
+ * and comparisons of the results are exact.
+ *
+ * @param ingredient The ingredient to get the cost of.
+ * @return The cost in micro-units.
+ */
+int64_t ingredientGetCostMicros(Ingredient ingredient);
+
+/*
+ * Returns the cost the given number of micro-units represent.
+ *
+ * @param micros The cost in micro-units.
+ * @return The cost.
+ */
+double ingredientCostFromMicros(int64_t micros);
+
 /*
  * Returns the quality of the ingredient.
  * The quality computation formula is given in the PDF.
@@ -143,6 +345,29 @@ IngredientResult ingredientChangeCost(Ingredient* ingredient, double cost, int d
  */
 double ingredientGetQuality(Ingredient ingredient);
 
+/*
+ * Returns the quality of an ingredient with the given calories and health,
+ * as ingredientGetQuality does.
+ *
+ * @param calories The ingredient's calories.
+ * @param health The ingredient's health.
+ * @return The quality.
+ */
+double ingredientGetQualityOf(int calories, int health);
+
+/*
+ * The quality of every valid (calories, health) pair, at index
+ * INGREDIENT_QUALITY_INDEX(calories, health). The table is filled from the
+ * defines above before main runs and never written again, so it can be read
+ * from any thread, and by vector code that gathers several qualities at once.
+ */
+#define INGREDIENT_HEALTH_VALUES (INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH+1)
+#define INGREDIENT_QUALITY_INDEX(calories, health) \
+	(((calories)-INGREDIENT_MIN_CALORIES)*INGREDIENT_HEALTH_VALUES + \
+	((health)-INGREDIENT_MIN_HEALTH))
+
+extern const double* const ingredientQualityTable;
+
 /*
  * Returns true if ingredient1 is cheaper than ingredient2, and false otherwise.
  *
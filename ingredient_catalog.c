@@ -0,0 +1,342 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ingredient_catalog.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return INGREDIENT_CATALOG_NULL_ARGUMENT;	}
+
+#define CATALOG_MAGIC "INGRCAT"
+#define CATALOG_BYTE_ORDER_MARK UINT32_C(0x01020304)
+#define CATALOG_WRITE_BATCH 1024
+#define CATALOG_TEMP_SUFFIX ".XXXXXX"
+#define CATALOG_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)
+
+#define STATIC_CHECK(condition, name) typedef char name[(condition) ? 1 : -1]
+
+/*
+ * A record has the members of Ingredient, in the same order, so it has the
+ * same layout as Ingredient has when names aren't interned.
+ */
+typedef struct catalog_record_t {
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	KosherType kosherType;
+	int calories;
+	int health;
+	double cost;
+} CatalogRecord;
+
+#ifndef INGREDIENT_INTERNED_NAMES
+/*
+ * ingredientCatalogIngredients hands out the records as ingredients, so the
+ * two layouts must match member for member.
+ */
+#define SAME_OFFSET(member) \
+	(offsetof(CatalogRecord,member) == offsetof(Ingredient,member))
+STATIC_CHECK(sizeof(CatalogRecord) == sizeof(Ingredient), recordSizeMatches);
+STATIC_CHECK(SAME_OFFSET(name) && sizeof(((CatalogRecord*)0)->name) ==
+			sizeof(((Ingredient*)0)->name), recordNameMatches);
+STATIC_CHECK(SAME_OFFSET(kosherType), recordKosherTypeMatches);
+STATIC_CHECK(SAME_OFFSET(calories), recordCaloriesMatch);
+STATIC_CHECK(SAME_OFFSET(health), recordHealthMatches);
+STATIC_CHECK(SAME_OFFSET(cost), recordCostMatches);
+STATIC_CHECK(sizeof(ValidIngredient) == sizeof(Ingredient),
+			validIngredientSizeMatches);
+#endif
+
+typedef struct catalog_header_t {
+	char magic[8];
+	uint32_t version;
+	uint32_t byteOrderMark;
+	uint32_t recordSize;
+	uint32_t reserved;
+	uint64_t count;
+	uint64_t checksum;
+} CatalogHeader;
+
+struct ingredient_catalog_t {
+	void* mapping;
+	size_t mappingSize;
+	const CatalogRecord* records;
+	int count;
+	uint64_t checksum;
+};
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+/*
+ * 64 bit FNV-1a over the 8 byte words of the records. Writers zero every
+ * record before filling it, so padding bytes are deterministic.
+ */
+static uint64_t checksumUpdate(uint64_t checksum, const CatalogRecord* records,
+							int count) {
+	const unsigned char* bytes = (const unsigned char*)records;
+	size_t words = sizeof(CatalogRecord)*count/sizeof(uint64_t);
+	for (size_t i=0;i<words;i++) {
+		uint64_t word;
+		memcpy(&word,bytes+i*sizeof(uint64_t),sizeof(uint64_t));
+		checksum ^= word;
+		checksum *= UINT64_C(1099511628211);
+	}
+	return checksum;
+}
+
+static uint64_t checksumStart() {
+	return UINT64_C(14695981039346656037);
+}
+
+static bool fillRecord(Ingredient ingredient, CatalogRecord* record) {
+	if (ingredientValidate(ingredient) != INGREDIENT_SUCCESS) {
+		return false;
+	}
+	memset(record,0,sizeof(*record));
+	strcpy(record->name,ingredientPeekName(&ingredient));
+	record->kosherType = ingredient.kosherType;
+	record->calories = ingredient.calories;
+	record->health = ingredient.health;
+	record->cost = ingredient.cost;
+	return true;
+}
+
+static void fillHeader(CatalogHeader* header, uint64_t count,
+					uint64_t checksum) {
+	memset(header,0,sizeof(*header));
+	strcpy(header->magic,CATALOG_MAGIC);
+	header->version = INGREDIENT_CATALOG_VERSION;
+	header->byteOrderMark = CATALOG_BYTE_ORDER_MARK;
+	header->recordSize = sizeof(CatalogRecord);
+	header->count = count;
+	header->checksum = checksum;
+}
+
+static bool writeBlock(FILE* file, const void* block, size_t size) {
+	return fwrite(block,1,size,file) == size;
+}
+
+static bool writeHeader(FILE* file, uint64_t count, uint64_t checksum) {
+	char const padding[INGREDIENT_CATALOG_HEADER_SIZE-sizeof(CatalogHeader)] =
+																		{ 0 };
+	CatalogHeader header;
+	fillHeader(&header,count,checksum);
+	return writeBlock(file,&header,sizeof(header)) &&
+			writeBlock(file,padding,sizeof(padding));
+}
+
+static IngredientCatalogResult writeCatalog(FILE* file,
+									const Ingredient* ingredients, int count) {
+	CatalogRecord batch[CATALOG_WRITE_BATCH];
+	if (!writeHeader(file,0,0)) {
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	uint64_t checksum = checksumStart();
+	for (int written=0;written<count;written+=CATALOG_WRITE_BATCH) {
+		int size = count-written < CATALOG_WRITE_BATCH ? count-written :
+													CATALOG_WRITE_BATCH;
+		for (int i=0;i<size;i++) {
+			if (!fillRecord(ingredients[written+i],batch+i)) {
+				return INGREDIENT_CATALOG_BAD_INGREDIENT;
+			}
+		}
+		checksum = checksumUpdate(checksum,batch,size);
+		if (!writeBlock(file,batch,sizeof(CatalogRecord)*size)) {
+			return INGREDIENT_CATALOG_IO_ERROR;
+		}
+	}
+	if (fseek(file,0,SEEK_SET) != 0 || !writeHeader(file,count,checksum)) {
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	return INGREDIENT_CATALOG_SUCCESS;
+}
+
+static IngredientCatalogResult checkHeader(const void* mapping, size_t size,
+										int* count, uint64_t* checksum) {
+	if (size < INGREDIENT_CATALOG_HEADER_SIZE) {
+		return INGREDIENT_CATALOG_BAD_FORMAT;
+	}
+	CatalogHeader header;
+	memcpy(&header,mapping,sizeof(header));
+	if (memcmp(header.magic,CATALOG_MAGIC,sizeof(CATALOG_MAGIC)) != 0 ||
+			header.version != INGREDIENT_CATALOG_VERSION ||
+			header.byteOrderMark != CATALOG_BYTE_ORDER_MARK ||
+			header.recordSize != sizeof(CatalogRecord) ||
+			header.count > (uint64_t)INT32_MAX ||
+			INGREDIENT_CATALOG_HEADER_SIZE +
+				header.count*sizeof(CatalogRecord) != size) {
+		return INGREDIENT_CATALOG_BAD_FORMAT;
+	}
+	*count = (int)header.count;
+	*checksum = header.checksum;
+	return INGREDIENT_CATALOG_SUCCESS;
+}
+
+/*
+ * Copies a record, which the writer only wrote after validating it. When names
+ * are interned the name is added to the pool, which reads it as a string, so
+ * a name with no terminator is still rejected there.
+ */
+static IngredientCatalogResult readRecord(const CatalogRecord* record,
+										ValidIngredient* ingredient) {
+#ifdef INGREDIENT_INTERNED_NAMES
+	if (memchr(record->name,'\0',sizeof(record->name)) == NULL) {
+		return INGREDIENT_CATALOG_BAD_INGREDIENT;
+	}
+	Ingredient read;
+	if (namePoolIntern(record->name,&read.name) != NAME_POOL_SUCCESS) {
+		return INGREDIENT_CATALOG_OUT_OF_MEMORY;
+	}
+	read.kosherType = record->kosherType;
+	read.calories = record->calories;
+	read.health = record->health;
+	read.cost = record->cost;
+	ingredient->ingredient = read;
+#else
+	memcpy(ingredient,record,sizeof(*ingredient));
+#endif
+	return INGREDIENT_CATALOG_SUCCESS;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+IngredientCatalogResult ingredientCatalogWrite(const char* path,
+									const Ingredient* ingredients, int count) {
+	CHECK_NULL_ARG(path)
+	if (count > 0) {
+		CHECK_NULL_ARG(ingredients)
+	}
+	char* tempPath = (char*)malloc(strlen(path)+sizeof(CATALOG_TEMP_SUFFIX));
+	if (tempPath == NULL) {
+		return INGREDIENT_CATALOG_OUT_OF_MEMORY;
+	}
+	strcpy(tempPath,path);
+	strcat(tempPath,CATALOG_TEMP_SUFFIX);
+	/*
+	 * The catalog is written under a unique name next to path and renamed
+	 * over it, so concurrent writers never share a file and readers only see
+	 * complete catalogs.
+	 */
+	int fd = mkstemp(tempPath);
+	if (fd < 0) {
+		free(tempPath);
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	FILE* file = NULL;
+	if (fchmod(fd,CATALOG_FILE_MODE) != 0 ||
+			(file = fdopen(fd,"wb")) == NULL) {
+		close(fd);
+		remove(tempPath);
+		free(tempPath);
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	IngredientCatalogResult result = writeCatalog(file,ingredients,count);
+	if (fclose(file) != 0 && result == INGREDIENT_CATALOG_SUCCESS) {
+		result = INGREDIENT_CATALOG_IO_ERROR;
+	}
+	if (result == INGREDIENT_CATALOG_SUCCESS && rename(tempPath,path) != 0) {
+		result = INGREDIENT_CATALOG_IO_ERROR;
+	}
+	if (result != INGREDIENT_CATALOG_SUCCESS) {
+		remove(tempPath);
+	}
+	free(tempPath);
+	return result;
+}
+
+IngredientCatalogResult ingredientCatalogOpen(const char* path,
+											IngredientCatalog* catalog) {
+	CHECK_NULL_ARG(path)
+	CHECK_NULL_ARG(catalog)
+	int fd = open(path,O_RDONLY);
+	if (fd < 0) {
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	struct stat status;
+	if (fstat(fd,&status) != 0) {
+		close(fd);
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	size_t size = status.st_size;
+	if (size < INGREDIENT_CATALOG_HEADER_SIZE) {
+		close(fd);
+		return INGREDIENT_CATALOG_BAD_FORMAT;
+	}
+	void* mapping = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		return INGREDIENT_CATALOG_IO_ERROR;
+	}
+	int count;
+	uint64_t checksum;
+	IngredientCatalogResult result = checkHeader(mapping,size,&count,&checksum);
+	if (result != INGREDIENT_CATALOG_SUCCESS) {
+		munmap(mapping,size);
+		return result;
+	}
+	IngredientCatalog opened = (IngredientCatalog)malloc(sizeof(*opened));
+	if (opened == NULL) {
+		munmap(mapping,size);
+		return INGREDIENT_CATALOG_OUT_OF_MEMORY;
+	}
+	opened->mapping = mapping;
+	opened->mappingSize = size;
+	opened->records = (const CatalogRecord*)((const char*)mapping +
+											INGREDIENT_CATALOG_HEADER_SIZE);
+	opened->count = count;
+	opened->checksum = checksum;
+	*catalog = opened;
+	return INGREDIENT_CATALOG_SUCCESS;
+}
+
+void ingredientCatalogClose(IngredientCatalog catalog) {
+	if (catalog == NULL) {
+		return;
+	}
+	munmap(catalog->mapping,catalog->mappingSize);
+	free(catalog);
+}
+
+IngredientCatalogResult ingredientCatalogVerify(IngredientCatalog catalog) {
+	CHECK_NULL_ARG(catalog)
+	uint64_t checksum = checksumUpdate(checksumStart(),catalog->records,
+									catalog->count);
+	if (checksum != catalog->checksum) {
+		return INGREDIENT_CATALOG_BAD_CHECKSUM;
+	}
+	return INGREDIENT_CATALOG_SUCCESS;
+}
+
+int ingredientCatalogSize(IngredientCatalog catalog) {
+	if (catalog == NULL) {
+		return 0;
+	}
+	return catalog->count;
+}
+
+IngredientCatalogResult ingredientCatalogGet(IngredientCatalog catalog,
+									int index, ValidIngredient* ingredient) {
+	CHECK_NULL_ARG(catalog)
+	CHECK_NULL_ARG(ingredient)
+	if (index < 0 || index >= catalog->count) {
+		return INGREDIENT_CATALOG_OUT_OF_RANGE;
+	}
+	return readRecord(catalog->records+index,ingredient);
+}
+
+#ifndef INGREDIENT_INTERNED_NAMES
+const ValidIngredient* ingredientCatalogIngredients(
+											IngredientCatalog catalog) {
+	if (catalog == NULL) {
+		return NULL;
+	}
+	return (const ValidIngredient*)catalog->records;
+}
+#endif
@@ -0,0 +1,147 @@
+/*
+ * ingredient_catalog.h
+ *
+ * A binary file format for ingredient catalogs that is used by mapping the
+ * file into memory. Records are stored with the layout of Ingredient, so an
+ * opened catalog is read in place, with no parsing and no per-record
+ * construction. The writer only accepts valid ingredients, so the records
+ * don't need to be validated again when the catalog is opened.
+ *
+ * A file starts with a header holding a magic string, the format version,
+ * a byte order mark, the size of a record, the number of records and a
+ * checksum of the records. Records start INGREDIENT_CATALOG_HEADER_SIZE bytes
+ * into the file. Since records use the in-memory layout, a catalog can only be
+ * opened by a program built for the same record size and byte order, which
+ * the header lets ingredientCatalogOpen check.
+ */
+
+#ifndef INGREDIENT_CATALOG_H_
+#define INGREDIENT_CATALOG_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Defines & Enums
+ ******************************************************************************/
+#define INGREDIENT_CATALOG_VERSION 1
+#define INGREDIENT_CATALOG_HEADER_SIZE 64
+
+/*******************************************************************************
+ * Ingredient Catalog Struct
+ ******************************************************************************/
+typedef struct ingredient_catalog_t* IngredientCatalog;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	INGREDIENT_CATALOG_SUCCESS,			/* Operation succeeded 				  */
+	INGREDIENT_CATALOG_NULL_ARGUMENT,	/* A NULL argument was passed 		  */
+	INGREDIENT_CATALOG_OUT_OF_RANGE,	/* The passed record index is negative
+										   or out of bounds					  */
+	INGREDIENT_CATALOG_BAD_INGREDIENT,	/* An invalid ingredient was passed	  */
+	INGREDIENT_CATALOG_BAD_FORMAT,		/* The file isn't a catalog of this
+										   version, record size and byte
+										   order, or it is truncated		  */
+	INGREDIENT_CATALOG_BAD_CHECKSUM,	/* The records don't match the
+										   checksum in the header			  */
+	INGREDIENT_CATALOG_IO_ERROR,		/* Reading or writing the file failed */
+	INGREDIENT_CATALOG_OUT_OF_MEMORY	/* A memory error occured			  */
+} IngredientCatalogResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Write @count ingredients to a catalog file, replacing the file at @path.
+ * The catalog is written to a temporary file next to it first, so @path
+ * never holds a partly written catalog.
+ * If one of the ingredients isn't valid, as ingredientInitialize defines
+ * it, INGREDIENT_CATALOG_BAD_INGREDIENT is returned and nothing is written.
+ *
+ * @param path The path of the catalog file.
+ * @param ingredients The ingredients to write.
+ * @param count The number of ingredients.
+ * @return Success or error code.
+ */
+IngredientCatalogResult ingredientCatalogWrite(const char* path,
+									const Ingredient* ingredients, int count);
+
+/*
+ * Open a catalog file by mapping it into memory, placing it in @catalog.
+ * The header is checked, but the checksum isn't, so opening takes constant
+ * time. Use ingredientCatalogVerify to check the records as well.
+ *
+ * @param path The path of the catalog file.
+ * @param catalog The opened catalog will be placed here.
+ * @return Success or error code.
+ */
+IngredientCatalogResult ingredientCatalogOpen(const char* path,
+											IngredientCatalog* catalog);
+
+/*
+ * Close a catalog, unmapping its file. Ingredients returned by
+ * ingredientCatalogIngredients can't be used after that.
+ *
+ * @param catalog The catalog to close.
+ */
+void ingredientCatalogClose(IngredientCatalog catalog);
+
+/*
+ * Check the catalog's records against the checksum in its header.
+ *
+ * @param catalog The catalog to check.
+ * @return INGREDIENT_CATALOG_BAD_CHECKSUM if the records were changed since
+ * the catalog was written, or another success or error code.
+ */
+IngredientCatalogResult ingredientCatalogVerify(IngredientCatalog catalog);
+
+/*
+ * Returns the number of ingredients in the catalog, or 0 if @catalog is NULL.
+ *
+ * @param catalog The catalog to query.
+ * @return The number of ingredients.
+ */
+int ingredientCatalogSize(IngredientCatalog catalog);
+
+/*
+ * Place a copy of one of the catalog's ingredients in @ingredient.
+ * The writer only writes valid ingredients, so the record is copied as is,
+ * without checking it again. Use ingredientCatalogVerify first if the file
+ * may have been changed since it was written.
+ * When names are interned the ingredient's name is interned as well, which
+ * may fail with INGREDIENT_CATALOG_OUT_OF_MEMORY, and a record whose name
+ * has no terminator returns INGREDIENT_CATALOG_BAD_INGREDIENT.
+ *
+ * @param catalog The catalog to read.
+ * @param index The index of the ingredient.
+ * @param ingredient The ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientCatalogResult ingredientCatalogGet(IngredientCatalog catalog,
+									int index, ValidIngredient* ingredient);
+
+#ifndef INGREDIENT_INTERNED_NAMES
+/*
+ * Returns the catalog's ingredients, in place in the mapped file.
+ * The array holds ingredientCatalogSize ingredients and stays valid until the
+ * catalog is closed. Returns NULL if @catalog is NULL. As with
+ * ingredientCatalogGet, the records are trusted to be as the writer wrote
+ * them.
+ * Not available when names are interned, as the records then don't have the
+ * layout of Ingredient.
+ *
+ * @param catalog The catalog to read.
+ * @return The catalog's ingredients.
+ */
+const ValidIngredient* ingredientCatalogIngredients(
+											IngredientCatalog catalog);
+#endif
+
+#endif /* INGREDIENT_CATALOG_H_ */
@@ -0,0 +1,181 @@
+#include "ingredient_catalog.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, INGREDIENT_CATALOG_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) \
+	ASSERT_EQUALS(expr, INGREDIENT_CATALOG_NULL_ARGUMENT)
+#define ASSERT_BAD_FORMAT(expr) ASSERT_EQUALS(expr, INGREDIENT_CATALOG_BAD_FORMAT)
+
+#define TEST_FILE "ingredient_catalog_test.tmp"
+#define TEST_ROWS 5000
+
+static void fillIngredients(Ingredient* ingredients, int count) {
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	for (int i=0;i<count;i++) {
+		sprintf(name, "Ingredient %d", i);
+		ingredients[i] = ingredientInitialize(name, (KosherType)(i % 3),
+			i % (INGREDIENT_MAX_CALORIES+1), i % (INGREDIENT_MAX_HEALTH+1),
+			i*0.25, NULL);
+	}
+}
+
+static bool sameIngredient(Ingredient ingredient1, Ingredient ingredient2) {
+	return strcmp(ingredientPeekName(&ingredient1),
+				ingredientPeekName(&ingredient2)) == 0 &&
+			ingredient1.kosherType == ingredient2.kosherType &&
+			ingredient1.calories == ingredient2.calories &&
+			ingredient1.health == ingredient2.health &&
+			ingredient1.cost == ingredient2.cost;
+}
+
+/* Overwrites one byte of the test file */
+static bool patchFile(long offset, char value) {
+	FILE* file = fopen(TEST_FILE, "r+b");
+	if (file == NULL || fseek(file, offset, SEEK_SET) != 0) {
+		return false;
+	}
+	fputc(value, file);
+	fclose(file);
+	return true;
+}
+
+static bool testWriteAndOpen() {
+	static Ingredient ingredients[TEST_ROWS];
+	fillIngredients(ingredients, TEST_ROWS);
+	IngredientCatalog catalog;
+
+	ASSERT_NULL_ARGUMENT(ingredientCatalogWrite(NULL, ingredients, 1));
+	ASSERT_NULL_ARGUMENT(ingredientCatalogWrite(TEST_FILE, NULL, 1));
+	ASSERT_NULL_ARGUMENT(ingredientCatalogOpen(TEST_FILE, NULL));
+	ASSERT_EQUALS(ingredientCatalogOpen("no/such/file", &catalog),
+				INGREDIENT_CATALOG_IO_ERROR);
+
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, TEST_ROWS));
+	ASSERT_SUCCESS(ingredientCatalogOpen(TEST_FILE, &catalog));
+	ASSERT_EQUALS(ingredientCatalogSize(catalog), TEST_ROWS);
+	ASSERT_SUCCESS(ingredientCatalogVerify(catalog));
+
+	ValidIngredient ingredient;
+	ASSERT_EQUALS(ingredientCatalogGet(catalog, -1, &ingredient),
+				INGREDIENT_CATALOG_OUT_OF_RANGE);
+	ASSERT_EQUALS(ingredientCatalogGet(catalog, TEST_ROWS, &ingredient),
+				INGREDIENT_CATALOG_OUT_OF_RANGE);
+	for (int i=0;i<TEST_ROWS;i++) {
+		ASSERT_SUCCESS(ingredientCatalogGet(catalog, i, &ingredient));
+		ASSERT(sameIngredient(ingredient.ingredient, ingredients[i]));
+	}
+#ifndef INGREDIENT_INTERNED_NAMES
+	const ValidIngredient* mapped = ingredientCatalogIngredients(catalog);
+	ASSERT_NOT_EQUALS(mapped, NULL);
+	for (int i=0;i<TEST_ROWS;i++) {
+		ASSERT(sameIngredient(mapped[i].ingredient, ingredients[i]));
+	}
+	ASSERT_EQUALS(ingredientCatalogIngredients(NULL), NULL);
+#endif
+	ingredientCatalogClose(catalog);
+	ingredientCatalogClose(NULL);
+
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, NULL, 0));
+	ASSERT_SUCCESS(ingredientCatalogOpen(TEST_FILE, &catalog));
+	ASSERT_EQUALS(ingredientCatalogSize(catalog), 0);
+	ASSERT_SUCCESS(ingredientCatalogVerify(catalog));
+	ingredientCatalogClose(catalog);
+
+	remove(TEST_FILE);
+	return true;
+}
+
+static bool testBadIngredient() {
+	Ingredient ingredients[3];
+	fillIngredients(ingredients, 3);
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, 3));
+
+	ingredients[2].calories = -1;
+	ASSERT_EQUALS(ingredientCatalogWrite(TEST_FILE, ingredients, 3),
+				INGREDIENT_CATALOG_BAD_INGREDIENT);
+
+	IngredientCatalog catalog;
+	ASSERT_SUCCESS(ingredientCatalogOpen(TEST_FILE, &catalog));
+	ASSERT_EQUALS(ingredientCatalogSize(catalog), 3);
+	ingredientCatalogClose(catalog);
+
+	remove(TEST_FILE);
+	return true;
+}
+
+static bool testCorruption() {
+	Ingredient ingredients[10];
+	fillIngredients(ingredients, 10);
+	IngredientCatalog catalog;
+
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, 10));
+	ASSERT(patchFile(INGREDIENT_CATALOG_HEADER_SIZE + 3, 'X'));
+	ASSERT_SUCCESS(ingredientCatalogOpen(TEST_FILE, &catalog));
+	ASSERT_EQUALS(ingredientCatalogVerify(catalog),
+				INGREDIENT_CATALOG_BAD_CHECKSUM);
+	ingredientCatalogClose(catalog);
+
+	/* records are trusted by Get, so a changed one is found by Verify */
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, 10));
+	for (int i=0;i<=INGREDIENT_MAX_NAME_LENGTH;i++) {
+		ASSERT(patchFile(INGREDIENT_CATALOG_HEADER_SIZE + i, 'X'));
+	}
+	ASSERT_SUCCESS(ingredientCatalogOpen(TEST_FILE, &catalog));
+	ASSERT_EQUALS(ingredientCatalogVerify(catalog),
+				INGREDIENT_CATALOG_BAD_CHECKSUM);
+	ValidIngredient ingredient;
+#ifdef INGREDIENT_INTERNED_NAMES
+	ASSERT_EQUALS(ingredientCatalogGet(catalog, 0, &ingredient),
+				INGREDIENT_CATALOG_BAD_INGREDIENT);
+#endif
+	ASSERT_SUCCESS(ingredientCatalogGet(catalog, 1, &ingredient));
+	ASSERT(sameIngredient(ingredient.ingredient, ingredients[1]));
+	ingredientCatalogClose(catalog);
+
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, 10));
+	ASSERT(patchFile(0, 'X'));
+	ASSERT_BAD_FORMAT(ingredientCatalogOpen(TEST_FILE, &catalog));
+
+	ASSERT_SUCCESS(ingredientCatalogWrite(TEST_FILE, ingredients, 10));
+	FILE* file = fopen(TEST_FILE, "ab");
+	ASSERT_NOT_EQUALS(file, NULL);
+	fputc(0, file);
+	fclose(file);
+	ASSERT_BAD_FORMAT(ingredientCatalogOpen(TEST_FILE, &catalog));
+
+	file = fopen(TEST_FILE, "wb");
+	ASSERT_NOT_EQUALS(file, NULL);
+	fputs("Tomato,PARVE,30,9,1.5\n", file);
+	fclose(file);
+	ASSERT_BAD_FORMAT(ingredientCatalogOpen(TEST_FILE, &catalog));
+
+	remove(TEST_FILE);
+	return true;
+}
+
+int main() {
+	RUN_TEST(testWriteAndOpen);
+	RUN_TEST(testBadIngredient);
+	RUN_TEST(testCorruption);
+	return 0;
+}
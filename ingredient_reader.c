@@ -0,0 +1,462 @@
+#define _POSIX_C_SOURCE 200112L
+#define _FILE_OFFSET_BITS 64
+#include <sys/types.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <pthread.h>
+#include "ingredient_reader.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return INGREDIENT_READER_NULL_ARGUMENT;	}
+
+#define READER_FIELDS 5
+#define READER_MAX_INT_DIGITS 9
+#define READER_MAX_COST_LENGTH 63
+
+/*
+ * data[start..end) is the input that was read but not parsed yet, and data[0]
+ * is at position base of the input. A file reader owns data and refills it
+ * from the file; a buffer reader points data at the whole buffer.
+ * skipping is set while the rest of a line is being thrown away, and rows
+ * that start at limit or after it aren't read, unless limit is negative.
+ */
+struct ingredient_reader_t {
+	FILE* file;
+	char* chunk;
+	const char* data;
+	size_t start;
+	size_t end;
+	bool atEnd;
+	bool skipping;
+	int64_t base;
+	int64_t limit;
+	int64_t rowOffset;
+};
+
+typedef struct reader_range_t {
+	const char* path;
+	int64_t begin;
+	int64_t end;
+	IngredientReaderRowFunction function;
+	void* context;
+	IngredientReaderResult result;
+} ReaderRange;
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+static IngredientReader readerCreate() {
+	IngredientReader reader = (IngredientReader)malloc(sizeof(*reader));
+	if (reader == NULL) {
+		return NULL;
+	}
+	reader->file = NULL;
+	reader->chunk = NULL;
+	reader->data = NULL;
+	reader->start = 0;
+	reader->end = 0;
+	reader->atEnd = true;
+	reader->skipping = false;
+	reader->base = 0;
+	reader->limit = -1;
+	reader->rowOffset = -1;
+	return reader;
+}
+
+/*
+ * Moves the unread input to the front of the chunk and reads more after it.
+ */
+static IngredientReaderResult readerRefill(IngredientReader reader) {
+	size_t unread = reader->end-reader->start;
+	memmove(reader->chunk,reader->chunk+reader->start,unread);
+	reader->base += reader->start;
+	reader->start = 0;
+	reader->end = unread;
+	reader->end += fread(reader->chunk+unread,1,
+						INGREDIENT_READER_CHUNK_SIZE-unread,reader->file);
+	if (ferror(reader->file)) {
+		return INGREDIENT_READER_IO_ERROR;
+	}
+	reader->atEnd = feof(reader->file);
+	return INGREDIENT_READER_SUCCESS;
+}
+
+/*
+ * Places the next line, without its line break, in @line and @length.
+ */
+static IngredientReaderResult readerNextLine(IngredientReader reader,
+										const char** line, size_t* length) {
+	while (true) {
+		if (!reader->skipping && reader->limit >= 0 &&
+				reader->base+(int64_t)reader->start >= reader->limit) {
+			return INGREDIENT_READER_END_OF_INPUT;
+		}
+		const char* begin = reader->data+reader->start;
+		size_t unread = reader->end-reader->start;
+		const char* newline = (const char*)memchr(begin,'\n',unread);
+		if (newline != NULL || (reader->atEnd && unread > 0)) {
+			size_t lineLength = newline != NULL ? (size_t)(newline-begin) :
+												unread;
+			reader->rowOffset = reader->base+reader->start;
+			reader->start += newline != NULL ? lineLength+1 : lineLength;
+			if (reader->skipping) {
+				reader->skipping = false;
+				continue;
+			}
+			*line = begin;
+			*length = lineLength;
+			return INGREDIENT_READER_SUCCESS;
+		}
+		if (reader->atEnd) {
+			return INGREDIENT_READER_END_OF_INPUT;
+		}
+		if (unread == INGREDIENT_READER_CHUNK_SIZE) {
+			bool wasSkipping = reader->skipping;
+			reader->rowOffset = reader->base+reader->start;
+			reader->start = reader->end;
+			reader->skipping = true;
+			if (!wasSkipping) {
+				return INGREDIENT_READER_ROW_TOO_LONG;
+			}
+		}
+		IngredientReaderResult result = readerRefill(reader);
+		if (result != INGREDIENT_READER_SUCCESS) {
+			return result;
+		}
+	}
+}
+
+static bool fieldEquals(const char* field, size_t length, const char* text) {
+	return strlen(text) == length && memcmp(field,text,length) == 0;
+}
+
+static KosherType parseKosherType(const char* field, size_t length) {
+	if (fieldEquals(field,length,"MEATY")) {
+		return MEATY;
+	}
+	if (fieldEquals(field,length,"MILKY")) {
+		return MILKY;
+	}
+	if (fieldEquals(field,length,"PARVE")) {
+		return PARVE;
+	}
+	return (KosherType)INGREDIENT_KOSHER_TYPE_VALUES;
+}
+
+/*
+ * Parses an optionally negative decimal integer, returning @invalid if the
+ * field isn't one.
+ */
+static int parseInt(const char* field, size_t length, int invalid) {
+	bool negative = (length > 0 && field[0] == '-');
+	size_t i = negative ? 1 : 0;
+	if (i == length || length-i > READER_MAX_INT_DIGITS) {
+		return invalid;
+	}
+	int value = 0;
+	for (;i<length;i++) {
+		if (field[i] < '0' || field[i] > '9') {
+			return invalid;
+		}
+		value = value*10 + (field[i]-'0');
+	}
+	return negative ? -value : value;
+}
+
+/*
+ * Parses costs of the form "digits[.digits]". When the digits, without the
+ * point, form an integer below 2^53 and there are at most 22 of them after
+ * the point, both the integer and the power of ten are exact doubles, so a
+ * single division gives the correctly rounded result, the same one strtod
+ * gives. Returns false for any other field.
+ */
+static bool parseSimpleCost(const char* field, size_t length, double* cost) {
+	static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5,
+		1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+		1e18, 1e19, 1e20, 1e21, 1e22 };
+	uint64_t const MAX_EXACT = UINT64_C(1) << 53;
+	uint64_t digits = 0;
+	int fractionDigits = -1;
+	for (size_t i=0;i<length;i++) {
+		if (field[i] == '.' && fractionDigits < 0 && i > 0) {
+			fractionDigits = 0;
+			continue;
+		}
+		if (field[i] < '0' || field[i] > '9' || digits >= MAX_EXACT/10) {
+			return false;
+		}
+		digits = digits*10 + (field[i]-'0');
+		if (fractionDigits >= 0) {
+			fractionDigits++;
+		}
+	}
+	if (length == 0 || fractionDigits == 0 || fractionDigits > 22) {
+		return false;
+	}
+	*cost = (double)digits/POWERS_OF_TEN[fractionDigits < 0 ? 0 :
+														fractionDigits];
+	return true;
+}
+
+/*
+ * Returns NAN, which isn't a valid cost, if the field isn't a number.
+ */
+static double parseCost(const char* field, size_t length) {
+	char text[READER_MAX_COST_LENGTH + 1];
+	double cost;
+	if (parseSimpleCost(field,length,&cost)) {
+		return cost;
+	}
+	if (length == 0 || length > READER_MAX_COST_LENGTH) {
+		return NAN;
+	}
+	memcpy(text,field,length);
+	text[length] = '\0';
+	char* parsedEnd;
+	cost = strtod(text,&parsedEnd);
+	return (parsedEnd == text+length) ? cost : NAN;
+}
+
+/*
+ * Splits a line into its fields and builds its ingredient. Fields that can't
+ * be parsed are replaced by invalid values, so ingredientInitialize reports
+ * the error of the right field.
+ */
+static IngredientReaderResult parseRow(const char* line, size_t length,
+							Ingredient* ingredient, IngredientResult* result) {
+	const char* fields[READER_FIELDS];
+	size_t lengths[READER_FIELDS];
+	const char* rest = line;
+	size_t restLength = length;
+	for (int i=0;i<READER_FIELDS;i++) {
+		const char* comma = (const char*)memchr(rest,',',restLength);
+		if ((comma == NULL) != (i == READER_FIELDS-1)) {
+			return INGREDIENT_READER_BAD_ROW;
+		}
+		fields[i] = rest;
+		lengths[i] = restLength;
+		if (comma != NULL) {
+			lengths[i] = comma-rest;
+			rest = comma+1;
+			restLength -= lengths[i]+1;
+		}
+	}
+	if (lengths[0] > INGREDIENT_MAX_NAME_LENGTH) {
+		*result = INGREDIENT_BAD_NAME;
+		return INGREDIENT_READER_SUCCESS;
+	}
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	memcpy(name,fields[0],lengths[0]);
+	name[lengths[0]] = '\0';
+	*ingredient = ingredientInitialize(name,
+					parseKosherType(fields[1],lengths[1]),
+					parseInt(fields[2],lengths[2],INGREDIENT_MIN_CALORIES-1),
+					parseInt(fields[3],lengths[3],INGREDIENT_MIN_HEALTH-1),
+					parseCost(fields[4],lengths[4]),result);
+	return INGREDIENT_READER_SUCCESS;
+}
+
+/*
+ * Read the next row into a zeroed ingredient and result, so rows that fail
+ * to parse hand the row function defined values rather than the last row's.
+ */
+static IngredientReaderResult readRow(IngredientReader reader,
+		Ingredient* ingredient, IngredientResult* result) {
+	memset(ingredient,0,sizeof(*ingredient));
+	*result = INGREDIENT_SUCCESS;
+	return ingredientReaderNext(reader,ingredient,result);
+}
+
+static IngredientReaderResult readRange(ReaderRange* range) {
+	FILE* file = fopen(range->path,"rb");
+	if (file == NULL) {
+		return INGREDIENT_READER_IO_ERROR;
+	}
+	/*
+	 * A range owns the rows that start inside it. Starting one byte early and
+	 * skipping to the end of that line lands on the first of them.
+	 */
+	int64_t start = range->begin > 0 ? range->begin-1 : 0;
+	if (fseeko(file,(off_t)start,SEEK_SET) != 0) {
+		fclose(file);
+		return INGREDIENT_READER_IO_ERROR;
+	}
+	IngredientReader reader = ingredientReaderCreateFromFile(file);
+	if (reader == NULL) {
+		fclose(file);
+		return INGREDIENT_READER_OUT_OF_MEMORY;
+	}
+	reader->base = start;
+	reader->limit = range->end;
+	reader->skipping = (range->begin > 0);
+	IngredientReaderResult status;
+	Ingredient ingredient;
+	IngredientResult result;
+	while ((status = readRow(reader,&ingredient,&result)) ==
+				INGREDIENT_READER_SUCCESS ||
+			status == INGREDIENT_READER_BAD_ROW ||
+			status == INGREDIENT_READER_ROW_TOO_LONG) {
+		range->function(range->context,reader->rowOffset,status,ingredient,
+						result);
+	}
+	ingredientReaderDestroy(reader);
+	fclose(file);
+	return status == INGREDIENT_READER_END_OF_INPUT ?
+					INGREDIENT_READER_SUCCESS : status;
+}
+
+static void* readRangeThread(void* range) {
+	((ReaderRange*)range)->result = readRange((ReaderRange*)range);
+	return NULL;
+}
+
+static int64_t fileSize(const char* path) {
+	FILE* file = fopen(path,"rb");
+	if (file == NULL) {
+		return -1;
+	}
+	off_t size = -1;
+	if (fseeko(file,0,SEEK_END) == 0) {
+		size = ftello(file);
+	}
+	fclose(file);
+	return size;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+IngredientReader ingredientReaderCreateFromFile(FILE* file) {
+	if (file == NULL) {
+		return NULL;
+	}
+	IngredientReader reader = readerCreate();
+	if (reader == NULL) {
+		return NULL;
+	}
+	reader->chunk = (char*)malloc(INGREDIENT_READER_CHUNK_SIZE);
+	if (reader->chunk == NULL) {
+		free(reader);
+		return NULL;
+	}
+	reader->file = file;
+	reader->data = reader->chunk;
+	reader->atEnd = false;
+	return reader;
+}
+
+IngredientReader ingredientReaderCreateFromBuffer(const char* buffer,
+												size_t size) {
+	if (buffer == NULL) {
+		return NULL;
+	}
+	IngredientReader reader = readerCreate();
+	if (reader == NULL) {
+		return NULL;
+	}
+	reader->data = buffer;
+	reader->end = size;
+	return reader;
+}
+
+void ingredientReaderDestroy(IngredientReader reader) {
+	if (reader == NULL) {
+		return;
+	}
+	free(reader->chunk);
+	free(reader);
+}
+
+IngredientReaderResult ingredientReaderNext(IngredientReader reader,
+							Ingredient* ingredient, IngredientResult* result) {
+	CHECK_NULL_ARG(reader)
+	CHECK_NULL_ARG(ingredient)
+	CHECK_NULL_ARG(result)
+	while (true) {
+		const char* line;
+		size_t length;
+		IngredientReaderResult status = readerNextLine(reader,&line,&length);
+		if (status != INGREDIENT_READER_SUCCESS) {
+			return status;
+		}
+		if (length > 0 && line[length-1] == '\r') {
+			length--;
+		}
+		if (length > 0) {
+			return parseRow(line,length,ingredient,result);
+		}
+	}
+}
+
+IngredientReaderResult ingredientReaderNextValid(IngredientReader reader,
+						ValidIngredient* ingredient, IngredientResult* result) {
+	CHECK_NULL_ARG(ingredient)
+	Ingredient read;
+	IngredientReaderResult status = ingredientReaderNext(reader,&read,result);
+	if (status == INGREDIENT_READER_SUCCESS && *result == INGREDIENT_SUCCESS) {
+		ingredient->ingredient = read;
+	}
+	return status;
+}
+
+int64_t ingredientReaderGetOffset(IngredientReader reader) {
+	if (reader == NULL) {
+		return -1;
+	}
+	return reader->rowOffset;
+}
+
+IngredientReaderResult ingredientReadFileParallel(const char* path,
+	int threads, IngredientReaderRowFunction function, void* context) {
+	CHECK_NULL_ARG(path)
+	CHECK_NULL_ARG(function)
+	int64_t size = fileSize(path);
+	if (size < 0) {
+		return INGREDIENT_READER_IO_ERROR;
+	}
+#ifdef INGREDIENT_INTERNED_NAMES
+	threads = 1;
+#endif
+	if (threads < 1) {
+		threads = 1;
+	}
+	ReaderRange* ranges = (ReaderRange*)malloc(sizeof(ReaderRange)*threads);
+	pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t)*threads);
+	bool* started = (bool*)malloc(sizeof(bool)*threads);
+	if (ranges == NULL || ids == NULL || started == NULL) {
+		free(ranges);
+		free(ids);
+		free(started);
+		return INGREDIENT_READER_OUT_OF_MEMORY;
+	}
+	for (int i=0;i<threads;i++) {
+		ranges[i].path = path;
+		ranges[i].begin = size*i/threads;
+		ranges[i].end = size*(i+1)/threads;
+		ranges[i].function = function;
+		ranges[i].context = context;
+		started[i] = (i > 0 && pthread_create(&ids[i],NULL,readRangeThread,
+											&ranges[i]) == 0);
+	}
+	for (int i=0;i<threads;i++) {
+		if (!started[i]) {
+			readRangeThread(&ranges[i]);
+		}
+	}
+	IngredientReaderResult result = INGREDIENT_READER_SUCCESS;
+	for (int i=0;i<threads;i++) {
+		if (started[i]) {
+			pthread_join(ids[i],NULL);
+		}
+		if (result == INGREDIENT_READER_SUCCESS) {
+			result = ranges[i].result;
+		}
+	}
+	free(ranges);
+	free(ids);
+	free(started);
+	return result;
+}
@@ -0,0 +1,156 @@
+/*
+ * ingredient_reader.h
+ *
+ * A streaming reader of ingredient catalogs in CSV form. Each line holds one
+ * ingredient as
+ *
+ * 	name,kosher type,calories,health,cost
+ *
+ * where the kosher type is one of MEATY, MILKY or PARVE. Fields are not quoted,
+ * so names can't contain commas. Empty lines are skipped, and a line may end
+ * with "\r\n".
+ *
+ * Input is read in chunks of INGREDIENT_READER_CHUNK_SIZE bytes and fields are
+ * parsed where they lie in the chunk, so memory use doesn't depend on the
+ * size of the input.
+ */
+
+#ifndef INGREDIENT_READER_H_
+#define INGREDIENT_READER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ * Defines & Enums
+ ******************************************************************************/
+/* Also the longest line the reader accepts, including its line break */
+#define INGREDIENT_READER_CHUNK_SIZE (1 << 16)
+
+/*******************************************************************************
+ * Ingredient Reader Struct
+ ******************************************************************************/
+typedef struct ingredient_reader_t* IngredientReader;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	INGREDIENT_READER_SUCCESS,			/* Operation succeeded 				  */
+	INGREDIENT_READER_NULL_ARGUMENT,	/* A NULL argument was passed 		  */
+	INGREDIENT_READER_END_OF_INPUT,		/* There are no more rows to read	  */
+	INGREDIENT_READER_BAD_ROW,			/* The row doesn't have exactly five
+										   fields							  */
+	INGREDIENT_READER_ROW_TOO_LONG,		/* The row is longer than a chunk	  */
+	INGREDIENT_READER_IO_ERROR,			/* Reading the input failed			  */
+	INGREDIENT_READER_OUT_OF_MEMORY		/* A memory error occured			  */
+} IngredientReaderResult;
+
+/*
+ * A function that receives the rows read by ingredientReadFileParallel.
+ * @offset is the position of the row in the file. @status is what
+ * ingredientReaderNext returned for the row, and @ingredient and @result
+ * are only meaningful if it is INGREDIENT_READER_SUCCESS. For rows that fail
+ * to parse, @ingredient is all zero and @result is INGREDIENT_SUCCESS.
+ */
+typedef void (*IngredientReaderRowFunction)(void* context, int64_t offset,
+	IngredientReaderResult status, Ingredient ingredient,
+	IngredientResult result);
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a reader of an open file, starting at the file's current position.
+ * The file isn't closed by the reader.
+ *
+ * @param file The file to read.
+ * @return The new reader, or NULL if any error occured.
+ */
+IngredientReader ingredientReaderCreateFromFile(FILE* file);
+
+/*
+ * Create a reader of a buffer in memory. The buffer isn't copied, so it must
+ * stay unchanged until the reader is destroyed.
+ *
+ * @param buffer The buffer to read.
+ * @param size The number of bytes in the buffer.
+ * @return The new reader, or NULL if any error occured.
+ */
+IngredientReader ingredientReaderCreateFromBuffer(const char* buffer,
+												size_t size);
+
+/*
+ * Destroy a given reader, deallocating all necessary memory.
+ *
+ * @param reader The reader to destroy.
+ */
+void ingredientReaderDestroy(IngredientReader reader);
+
+/*
+ * Read the next row.
+ *
+ * A row that was split into fields returns INGREDIENT_READER_SUCCESS, and is
+ * built by ingredientInitialize, which places the row's success or error code
+ * in @result. A field that isn't a number, or isn't a kosher type, gets the
+ * error code of that field. A row that can't be split into fields returns
+ * INGREDIENT_READER_BAD_ROW or INGREDIENT_READER_ROW_TOO_LONG. Either way, the
+ * next call reads the row after it.
+ *
+ * @param reader The reader to read from.
+ * @param ingredient The row's ingredient will be placed here.
+ * @param result The row's success or error code will be placed here.
+ * @return Success or error code.
+ */
+IngredientReaderResult ingredientReaderNext(IngredientReader reader,
+							Ingredient* ingredient, IngredientResult* result);
+
+/*
+ * Read the next row as ingredientReaderNext does, placing its ingredient in
+ * @ingredient only if the row was read and @result is INGREDIENT_SUCCESS.
+ * The row's ingredient was built by ingredientInitialize, so it is handed
+ * out as a ValidIngredient without being checked again.
+ *
+ * @param reader The reader to read from.
+ * @param ingredient The row's ingredient will be placed here if it is valid.
+ * @param result The row's success or error code will be placed here.
+ * @return Success or error code.
+ */
+IngredientReaderResult ingredientReaderNextValid(IngredientReader reader,
+						ValidIngredient* ingredient, IngredientResult* result);
+
+/*
+ * Returns the position in the input of the row last returned by
+ * ingredientReaderNext, counted in bytes from where the reader started.
+ * Returns -1 if @reader is NULL.
+ *
+ * @param reader The reader to query.
+ * @return The row's position.
+ */
+int64_t ingredientReaderGetOffset(IngredientReader reader);
+
+/*
+ * Read all the rows of a file, splitting the file into @threads ranges that
+ * are read at the same time, each by its own reader.
+ * @function is called once for every row, from several threads at once and
+ * in no particular order, so it must be safe to call concurrently.
+ * When names are interned the name pool is shared, so the file is read by a
+ * single thread.
+ *
+ * @param path The path of the file to read.
+ * @param threads The number of threads to read with.
+ * @param function The function to pass the rows to.
+ * @param context Passed to @function with every row.
+ * @return INGREDIENT_READER_IO_ERROR or INGREDIENT_READER_OUT_OF_MEMORY if a
+ * range couldn't be read, and INGREDIENT_READER_SUCCESS otherwise.
+ */
+IngredientReaderResult ingredientReadFileParallel(const char* path,
+	int threads, IngredientReaderRowFunction function, void* context);
+
+#endif /* INGREDIENT_READER_H_ */
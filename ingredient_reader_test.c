@@ -0,0 +1,243 @@
+#include "ingredient_reader.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+#define ASSERT_DOUBLE_EQUALS(expr,expected) ASSERT(DOUBLE_EQUALS(expr, expected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, INGREDIENT_READER_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) \
+	ASSERT_EQUALS(expr, INGREDIENT_READER_NULL_ARGUMENT)
+#define ASSERT_END(expr) ASSERT_EQUALS(expr, INGREDIENT_READER_END_OF_INPUT)
+
+#define TEST_FILE "ingredient_reader_test.tmp"
+#define TEST_ROWS 20000
+
+static bool testReadBuffer() {
+	const char csv[] =
+		"Tomato,PARVE,30,9,1.5\n"
+		"Cheese,DAIRY,300,3,12\n"
+		"\n"
+		"Steak,MEATY,lots,5,40\r\n"
+		"Broken,MEATY,10,5\n"
+		",PARVE,1,1,1\n"
+		"Butter,MILKY,700,1,5";
+	Ingredient ingredient;
+	IngredientResult result;
+
+	ASSERT_EQUALS(ingredientReaderCreateFromBuffer(NULL, 0), NULL);
+	IngredientReader reader = ingredientReaderCreateFromBuffer(csv,
+															strlen(csv));
+	ASSERT_NOT_EQUALS(reader, NULL);
+	ASSERT_NULL_ARGUMENT(ingredientReaderNext(NULL, &ingredient, &result));
+	ASSERT_NULL_ARGUMENT(ingredientReaderNext(reader, NULL, &result));
+
+	ASSERT_SUCCESS(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&ingredient), "Tomato"), 0);
+	ASSERT_EQUALS(ingredient.kosherType, PARVE);
+	ASSERT_EQUALS(ingredient.calories, 30);
+	ASSERT_EQUALS(ingredient.health, 9);
+	ASSERT_DOUBLE_EQUALS(ingredient.cost, 1.5);
+	ASSERT_EQUALS(ingredientReaderGetOffset(reader), 0);
+
+	ASSERT_SUCCESS(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_BAD_KOSHER_TYPE);
+	ASSERT_EQUALS(ingredientReaderGetOffset(reader), 22);
+
+	ASSERT_SUCCESS(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_BAD_CALORIES);
+
+	ASSERT_EQUALS(ingredientReaderNext(reader, &ingredient, &result),
+				INGREDIENT_READER_BAD_ROW);
+
+	ASSERT_SUCCESS(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_BAD_NAME);
+
+	ASSERT_SUCCESS(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&ingredient), "Butter"), 0);
+	ASSERT_DOUBLE_EQUALS(ingredient.cost, 5);
+
+	ASSERT_END(ingredientReaderNext(reader, &ingredient, &result));
+	ASSERT_END(ingredientReaderNext(reader, &ingredient, &result));
+	ingredientReaderDestroy(reader);
+	ingredientReaderDestroy(NULL);
+	return true;
+}
+
+static bool testReadValid() {
+	const char csv[] =
+		"Tomato,PARVE,30,9,1.5\n"
+		"Steak,MEATY,lots,5,40\n"
+		"Broken,MEATY,10,5\n"
+		"Butter,MILKY,700,1,5\n";
+	ValidIngredient ingredient;
+	IngredientResult result;
+	IngredientReader reader = ingredientReaderCreateFromBuffer(csv,
+															strlen(csv));
+	ASSERT_NOT_EQUALS(reader, NULL);
+	ASSERT_NULL_ARGUMENT(ingredientReaderNextValid(reader, NULL, &result));
+
+	ASSERT_SUCCESS(ingredientReaderNextValid(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&ingredient.ingredient), "Tomato"),
+				0);
+
+	/* rows that aren't valid leave the last valid ingredient in place */
+	ASSERT_SUCCESS(ingredientReaderNextValid(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_BAD_CALORIES);
+	ASSERT_EQUALS(ingredientReaderNextValid(reader, &ingredient, &result),
+				INGREDIENT_READER_BAD_ROW);
+	ASSERT_EQUALS(ingredient.ingredient.calories, 30);
+
+	ASSERT_SUCCESS(ingredientReaderNextValid(reader, &ingredient, &result));
+	ASSERT_EQUALS(result, INGREDIENT_SUCCESS);
+	ASSERT_EQUALS(ingredient.ingredient.kosherType, MILKY);
+	ASSERT_END(ingredientReaderNextValid(reader, &ingredient, &result));
+	ingredientReaderDestroy(reader);
+	return true;
+}
+
+static void writeRow(FILE* file, int row) {
+	fprintf(file, "Ingredient %d,%s,%d,%d,%d.25\n", row,
+			row % 3 == 0 ? "MEATY" : "PARVE", row % 2500, row % 10, row % 100);
+}
+
+static bool testReadFile() {
+	FILE* file = tmpfile();
+	ASSERT_NOT_EQUALS(file, NULL);
+	for (int row=0;row<TEST_ROWS;row++) {
+		writeRow(file, row);
+		if (row == TEST_ROWS/2) {
+			for (int i=0;i<INGREDIENT_READER_CHUNK_SIZE*2;i++) {
+				fputc('x', file);
+			}
+			fputc('\n', file);
+		}
+	}
+	rewind(file);
+
+	ASSERT_EQUALS(ingredientReaderCreateFromFile(NULL), NULL);
+	IngredientReader reader = ingredientReaderCreateFromFile(file);
+	ASSERT_NOT_EQUALS(reader, NULL);
+	Ingredient ingredient;
+	IngredientResult result;
+	IngredientReaderResult status;
+	int rows = 0, valid = 0, tooLong = 0;
+	while ((status = ingredientReaderNext(reader, &ingredient, &result)) !=
+			INGREDIENT_READER_END_OF_INPUT) {
+		if (status == INGREDIENT_READER_ROW_TOO_LONG) {
+			tooLong++;
+			continue;
+		}
+		ASSERT_SUCCESS(status);
+		if (result == INGREDIENT_SUCCESS) {
+			ASSERT_EQUALS(ingredient.health, rows % 10);
+			valid++;
+		} else {
+			ASSERT_EQUALS(result, INGREDIENT_BAD_CALORIES);
+			ASSERT_EQUALS(rows % 2500 > INGREDIENT_MAX_CALORIES, true);
+		}
+		rows++;
+	}
+	ASSERT_EQUALS(rows, TEST_ROWS);
+	ASSERT_EQUALS(tooLong, 1);
+	ASSERT_EQUALS(valid, TEST_ROWS - TEST_ROWS/2500*499);
+
+	ingredientReaderDestroy(reader);
+	fclose(file);
+	return true;
+}
+
+typedef struct {
+	int rows;
+	int valid;
+	long long caloriesSum;
+	long long offsetSum;
+	int cleanBad;
+} RowCounts;
+
+static void countRow(void* context, int64_t offset,
+	IngredientReaderResult status, Ingredient ingredient,
+	IngredientResult result) {
+	RowCounts* counts = context;
+	__atomic_fetch_add(&counts->rows, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&counts->offsetSum, offset, __ATOMIC_RELAXED);
+	if (status == INGREDIENT_READER_SUCCESS && result == INGREDIENT_SUCCESS) {
+		__atomic_fetch_add(&counts->valid, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&counts->caloriesSum, ingredient.calories,
+						__ATOMIC_RELAXED);
+	}
+	if (status == INGREDIENT_READER_BAD_ROW && result == INGREDIENT_SUCCESS &&
+			ingredient.calories == 0 && ingredient.health == 0 &&
+			ingredient.cost == 0) {
+		__atomic_fetch_add(&counts->cleanBad, 1, __ATOMIC_RELAXED);
+	}
+}
+
+static bool testReadFileParallel() {
+	FILE* file = fopen(TEST_FILE, "wb");
+	ASSERT_NOT_EQUALS(file, NULL);
+	long long caloriesSum = 0;
+	long long offsetSum = 0;
+	int valid = 0;
+	for (int row=0;row<TEST_ROWS;row++) {
+		offsetSum += ftell(file);
+		writeRow(file, row);
+		if (row % 2500 <= INGREDIENT_MAX_CALORIES) {
+			caloriesSum += row % 2500;
+			valid++;
+		}
+		if (row == TEST_ROWS/2) {
+			offsetSum += ftell(file);
+			fputs("Bad,PARVE,1\n", file);
+		}
+	}
+	fclose(file);
+
+	ASSERT_NULL_ARGUMENT(ingredientReadFileParallel(NULL, 2, countRow, NULL));
+	ASSERT_NULL_ARGUMENT(ingredientReadFileParallel(TEST_FILE, 2, NULL, NULL));
+	ASSERT_EQUALS(ingredientReadFileParallel("no/such/file", 2, countRow, NULL),
+				INGREDIENT_READER_IO_ERROR);
+
+	int threads[] = { 1, 3, 8, 64 };
+	for (int i=0;i<4;i++) {
+		RowCounts counts = { 0, 0, 0, 0, 0 };
+		ASSERT_SUCCESS(ingredientReadFileParallel(TEST_FILE, threads[i],
+												countRow, &counts));
+		ASSERT_EQUALS(counts.rows, TEST_ROWS + 1);
+		ASSERT_EQUALS(counts.valid, valid);
+		ASSERT_EQUALS(counts.cleanBad, 1);
+		ASSERT_EQUALS(counts.caloriesSum, caloriesSum);
+		ASSERT_EQUALS(counts.offsetSum, offsetSum);
+	}
+
+	remove(TEST_FILE);
+	return true;
+}
+
+int main() {
+	RUN_TEST(testReadBuffer);
+	RUN_TEST(testReadValid);
+	RUN_TEST(testReadFile);
+	RUN_TEST(testReadFileParallel);
+	return 0;
+}
@@ -0,0 +1,369 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+#include "ingredient_record.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return INGREDIENT_RECORD_NULL_ARGUMENT;	}
+
+#define FIELD_MASK(bits) ((UINT32_C(1) << (bits)) - 1)
+
+#define HEALTH_SHIFT INGREDIENT_RECORD_CALORIES_BITS
+#define KOSHER_SHIFT (HEALTH_SHIFT + INGREDIENT_RECORD_HEALTH_BITS)
+
+#define NAMES_MIN_CAPACITY 64
+
+/*
+ * Every packed field must be able to hold its whole range, and all of them
+ * must fit in the 32 bit attributes word. Each check declares an array type
+ * with a negative size, which doesn't compile, when it fails.
+ */
+#define STATIC_CHECK(condition, name) typedef char name[(condition) ? 1 : -1]
+
+STATIC_CHECK(INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES <=
+			FIELD_MASK(INGREDIENT_RECORD_CALORIES_BITS), caloriesFitRecord);
+STATIC_CHECK(INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH <=
+			FIELD_MASK(INGREDIENT_RECORD_HEALTH_BITS), healthFitsRecord);
+STATIC_CHECK(INGREDIENT_KOSHER_TYPE_VALUES-1 <=
+			FIELD_MASK(INGREDIENT_RECORD_KOSHER_BITS), kosherTypeFitsRecord);
+STATIC_CHECK(KOSHER_SHIFT+INGREDIENT_RECORD_KOSHER_BITS <= 32,
+			attributesFitRecord);
+
+/*
+ * Names are kept in an array indexed by id, each in its own allocation so
+ * returned strings never move. The slots array is an open addressing hash
+ * table with linear probing from name hashes to id+1, where 0 marks an empty
+ * slot. Names are never removed, so there are no tombstones.
+ */
+struct ingredient_record_names_t {
+	char** names;
+	unsigned int* hashes;
+	int size;
+	int namesCapacity;
+	int* slots;
+	int slotsCapacity;
+};
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+/* 32 bit FNV-1a */
+static unsigned int hashName(const char* name) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Returns the slot holding @name, or the empty slot where it would be
+ * inserted.
+ */
+static int findSlot(IngredientRecordNames names, const char* name,
+					unsigned int hash) {
+	int mask = names->slotsCapacity-1;
+	int slot = hash & mask;
+	while (names->slots[slot] != 0) {
+		int id = names->slots[slot]-1;
+		if (names->hashes[id] == hash && strcmp(names->names[id],name) == 0) {
+			return slot;
+		}
+		slot = (slot+1) & mask;
+	}
+	return slot;
+}
+
+static IngredientRecordResult growSlots(IngredientRecordNames names) {
+	int capacity = names->slotsCapacity == 0 ? NAMES_MIN_CAPACITY :
+											names->slotsCapacity*2;
+	int* slots = (int*)calloc(capacity,sizeof(int));
+	if (slots == NULL) {
+		return INGREDIENT_RECORD_OUT_OF_MEMORY;
+	}
+	free(names->slots);
+	names->slots = slots;
+	names->slotsCapacity = capacity;
+	int mask = capacity-1;
+	for (int id=0;id<names->size;id++) {
+		int slot = names->hashes[id] & mask;
+		while (names->slots[slot] != 0) {
+			slot = (slot+1) & mask;
+		}
+		names->slots[slot] = id+1;
+	}
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+static IngredientRecordResult growNames(IngredientRecordNames names) {
+	int capacity = names->namesCapacity == 0 ? NAMES_MIN_CAPACITY :
+											names->namesCapacity*2;
+	char** strings = (char**)realloc(names->names,sizeof(char*)*capacity);
+	if (strings == NULL) {
+		return INGREDIENT_RECORD_OUT_OF_MEMORY;
+	}
+	names->names = strings;
+	unsigned int* hashes = (unsigned int*)realloc(names->hashes,
+											sizeof(unsigned int)*capacity);
+	if (hashes == NULL) {
+		return INGREDIENT_RECORD_OUT_OF_MEMORY;
+	}
+	names->hashes = hashes;
+	names->namesCapacity = capacity;
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+/*
+ * Whether @value is in [@min, @max]. The checks above make sure such a value
+ * fits its field.
+ */
+static bool fitsField(int value, int min, int max) {
+	return value >= min && value <= max;
+}
+
+static bool canPack(Ingredient ingredient) {
+	return fitsField(ingredient.kosherType,0,INGREDIENT_KOSHER_TYPE_VALUES-1) &&
+			fitsField(ingredient.calories,INGREDIENT_MIN_CALORIES,
+					INGREDIENT_MAX_CALORIES) &&
+			fitsField(ingredient.health,INGREDIENT_MIN_HEALTH,
+					INGREDIENT_MAX_HEALTH) &&
+			isfinite(ingredient.cost) && ingredient.cost >= 0;
+}
+
+/* Whether the bits above the kosher type are clear. */
+static bool isValidAttributes(uint32_t attributes) {
+	return (attributes >> KOSHER_SHIFT >> INGREDIENT_RECORD_KOSHER_BITS) == 0;
+}
+
+/* The ingredient's name, or NULL if it has none. */
+static const char* ingredientName(const Ingredient* ingredient) {
+#ifndef INGREDIENT_INTERNED_NAMES
+	if (memchr(ingredient->name,'\0',sizeof(ingredient->name)) == NULL) {
+		return NULL;
+	}
+#endif
+	return ingredientPeekName(ingredient);
+}
+
+static IngredientRecordResult packName(IngredientRecordNames names,
+									Ingredient ingredient, uint32_t* id) {
+#ifdef INGREDIENT_INTERNED_NAMES
+	if (names == NULL) {
+		if (ingredientName(&ingredient) == NULL) {
+			return INGREDIENT_RECORD_BAD_INGREDIENT;
+		}
+		*id = ingredient.name.id;
+		return INGREDIENT_RECORD_SUCCESS;
+	}
+#endif
+	CHECK_NULL_ARG(names)
+	const char* name = ingredientName(&ingredient);
+	if (name == NULL) {
+		return INGREDIENT_RECORD_BAD_INGREDIENT;
+	}
+	return ingredientRecordNamesAdd(names,name,id);
+}
+
+/*
+ * Places the name with the given id in @ingredient. A name from a table is
+ * set through ingredientInitialize, so it is checked and, when names are
+ * interned, interned.
+ */
+static IngredientRecordResult restoreName(IngredientRecordNames names,
+										uint32_t id, Ingredient* ingredient) {
+#ifdef INGREDIENT_INTERNED_NAMES
+	if (names == NULL) {
+		if (namePoolFind(id,&ingredient->name) != NAME_POOL_SUCCESS) {
+			return INGREDIENT_RECORD_BAD_NAME;
+		}
+		return INGREDIENT_RECORD_SUCCESS;
+	}
+#endif
+	CHECK_NULL_ARG(names)
+	const char* name = ingredientRecordNamesGet(names,id);
+	if (name == NULL) {
+		return INGREDIENT_RECORD_BAD_NAME;
+	}
+	IngredientResult result;
+	*ingredient = ingredientInitialize(name,ingredient->kosherType,
+					ingredient->calories,ingredient->health,ingredient->cost,
+					&result);
+	if (result == INGREDIENT_OUT_OF_MEMORY) {
+		return INGREDIENT_RECORD_OUT_OF_MEMORY;
+	}
+	if (result == INGREDIENT_BAD_NAME) {
+		return INGREDIENT_RECORD_BAD_NAME;
+	}
+	return result == INGREDIENT_SUCCESS ? INGREDIENT_RECORD_SUCCESS :
+										INGREDIENT_RECORD_BAD_INGREDIENT;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+IngredientRecordNames ingredientRecordNamesCreate(void) {
+	IngredientRecordNames names = (IngredientRecordNames)malloc(sizeof(*names));
+	if (names == NULL) {
+		return NULL;
+	}
+	names->names = NULL;
+	names->hashes = NULL;
+	names->size = 0;
+	names->namesCapacity = 0;
+	names->slots = NULL;
+	names->slotsCapacity = 0;
+	return names;
+}
+
+void ingredientRecordNamesDestroy(IngredientRecordNames names) {
+	if (names == NULL) {
+		return;
+	}
+	for (int id=0;id<names->size;id++) {
+		free(names->names[id]);
+	}
+	free(names->names);
+	free(names->hashes);
+	free(names->slots);
+	free(names);
+}
+
+IngredientRecordResult ingredientRecordNamesAdd(IngredientRecordNames names,
+											const char* name, uint32_t* id) {
+	CHECK_NULL_ARG(names)
+	CHECK_NULL_ARG(name)
+	CHECK_NULL_ARG(id)
+	if ((names->size+1)*2 > names->slotsCapacity &&
+			growSlots(names) != INGREDIENT_RECORD_SUCCESS) {
+		return INGREDIENT_RECORD_OUT_OF_MEMORY;
+	}
+	unsigned int hash = hashName(name);
+	int slot = findSlot(names,name,hash);
+	if (names->slots[slot] == 0) {
+		if (names->size == names->namesCapacity &&
+				growNames(names) != INGREDIENT_RECORD_SUCCESS) {
+			return INGREDIENT_RECORD_OUT_OF_MEMORY;
+		}
+		char* copy = (char*)malloc(strlen(name)+1);
+		if (copy == NULL) {
+			return INGREDIENT_RECORD_OUT_OF_MEMORY;
+		}
+		strcpy(copy,name);
+		names->names[names->size] = copy;
+		names->hashes[names->size] = hash;
+		names->size++;
+		names->slots[slot] = names->size;
+	}
+	*id = (uint32_t)(names->slots[slot]-1);
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+const char* ingredientRecordNamesGet(IngredientRecordNames names, uint32_t id) {
+	if (names == NULL || id >= (uint32_t)names->size) {
+		return NULL;
+	}
+	return names->names[id];
+}
+
+int ingredientRecordNamesSize(IngredientRecordNames names) {
+	if (names == NULL) {
+		return 0;
+	}
+	return names->size;
+}
+
+IngredientRecordResult ingredientRecordPack(IngredientRecordNames names,
+							Ingredient ingredient, IngredientRecord* record) {
+	CHECK_NULL_ARG(record)
+	if (!canPack(ingredient)) {
+		return INGREDIENT_RECORD_BAD_INGREDIENT;
+	}
+	uint32_t name;
+	IngredientRecordResult result = packName(names,ingredient,&name);
+	if (result != INGREDIENT_RECORD_SUCCESS) {
+		return result;
+	}
+	record->cost = ingredient.cost;
+	record->name = name;
+	record->attributes =
+		(uint32_t)(ingredient.calories-INGREDIENT_MIN_CALORIES) |
+		(uint32_t)(ingredient.health-INGREDIENT_MIN_HEALTH) << HEALTH_SHIFT |
+		(uint32_t)ingredient.kosherType << KOSHER_SHIFT;
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+IngredientRecordResult ingredientRecordUnpack(IngredientRecordNames names,
+							IngredientRecord record, Ingredient* ingredient) {
+	CHECK_NULL_ARG(ingredient)
+	/* a record unpacks only into an ingredient that could have been packed */
+	Ingredient unpacked;
+	unpacked.kosherType = ingredientRecordGetKosherType(record);
+	unpacked.calories = ingredientRecordGetCalories(record);
+	unpacked.health = ingredientRecordGetHealth(record);
+	unpacked.cost = record.cost;
+	if (!isValidAttributes(record.attributes) || !canPack(unpacked)) {
+		return INGREDIENT_RECORD_BAD_INGREDIENT;
+	}
+	IngredientRecordResult result = restoreName(names,record.name,&unpacked);
+	if (result != INGREDIENT_RECORD_SUCCESS) {
+		return result;
+	}
+	*ingredient = unpacked;
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+IngredientRecordResult ingredientRecordPackArray(IngredientRecordNames names,
+		const Ingredient* ingredients, int count, IngredientRecord* records) {
+	CHECK_NULL_ARG(ingredients)
+	CHECK_NULL_ARG(records)
+	for (int i=0;i<count;i++) {
+		IngredientRecordResult result = ingredientRecordPack(names,
+													ingredients[i],records+i);
+		if (result != INGREDIENT_RECORD_SUCCESS) {
+			return result;
+		}
+	}
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+IngredientRecordResult ingredientRecordUnpackArray(IngredientRecordNames names,
+		const IngredientRecord* records, int count, Ingredient* ingredients) {
+	CHECK_NULL_ARG(records)
+	CHECK_NULL_ARG(ingredients)
+	for (int i=0;i<count;i++) {
+		IngredientRecordResult result = ingredientRecordUnpack(names,
+													records[i],ingredients+i);
+		if (result != INGREDIENT_RECORD_SUCCESS) {
+			return result;
+		}
+	}
+	return INGREDIENT_RECORD_SUCCESS;
+}
+
+KosherType ingredientRecordGetKosherType(IngredientRecord record) {
+	return (KosherType)((record.attributes >> KOSHER_SHIFT) &
+						FIELD_MASK(INGREDIENT_RECORD_KOSHER_BITS));
+}
+
+int ingredientRecordGetCalories(IngredientRecord record) {
+	return (int)(record.attributes &
+				FIELD_MASK(INGREDIENT_RECORD_CALORIES_BITS)) +
+			INGREDIENT_MIN_CALORIES;
+}
+
+int ingredientRecordGetHealth(IngredientRecord record) {
+	return (int)((record.attributes >> HEALTH_SHIFT) &
+				FIELD_MASK(INGREDIENT_RECORD_HEALTH_BITS)) +
+			INGREDIENT_MIN_HEALTH;
+}
+
+double ingredientRecordGetQuality(IngredientRecord record) {
+	Ingredient ingredient = {
+		.calories = ingredientRecordGetCalories(record),
+		.health = ingredientRecordGetHealth(record)
+	};
+	return ingredientGetQuality(ingredient);
+}
@@ -0,0 +1,189 @@
+/*
+ * ingredient_record.h
+ *
+ * A packed 16 byte form of Ingredient for large catalogs. The name is kept
+ * as a 32 bit id and the small integer fields are packed into a single word,
+ * so four records fit in a 64 byte cache line where a single Ingredient used
+ * to.
+ *
+ * Name ids are given out by an IngredientRecordNames side table, which the
+ * caller owns and keeps with its records, so packing works in every build.
+ * With INGREDIENT_INTERNED_NAMES a NULL table may be passed instead, and the
+ * ids are then the names' ids in the global name pool (see name_pool.h),
+ * which every ingredient already holds.
+ */
+
+#ifndef INGREDIENT_RECORD_H_
+#define INGREDIENT_RECORD_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include "name_pool.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Ingredient Record Struct
+ *
+ * name is the id of the ingredient's name in the IngredientRecordNames table
+ * the record was packed with, or in the name pool. attributes holds
+ * the calories above INGREDIENT_MIN_CALORIES in its low
+ * INGREDIENT_RECORD_CALORIES_BITS bits, the health above
+ * INGREDIENT_MIN_HEALTH in the next INGREDIENT_RECORD_HEALTH_BITS bits, and
+ * the kosher type in the INGREDIENT_RECORD_KOSHER_BITS bits above them.
+ * Use the accessors below rather than unpacking it by hand.
+ ******************************************************************************/
+#define INGREDIENT_RECORD_CALORIES_BITS 11
+#define INGREDIENT_RECORD_HEALTH_BITS 4
+#define INGREDIENT_RECORD_KOSHER_BITS 2
+
+typedef struct ingredient_record_t {
+	double cost;
+	uint32_t name;
+	uint32_t attributes;
+} IngredientRecord;
+
+/*
+ * A table of the names of a set of records, giving each distinct name the
+ * next id from 0 up. Ids stay valid until the table is destroyed.
+ */
+typedef struct ingredient_record_names_t* IngredientRecordNames;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	INGREDIENT_RECORD_SUCCESS,			/* Operation succeeded 				  */
+	INGREDIENT_RECORD_NULL_ARGUMENT,	/* A NULL argument was passed 		  */
+	INGREDIENT_RECORD_BAD_INGREDIENT,	/* The ingredient has a field that is
+										   invalid or doesn't fit its bits	  */
+	INGREDIENT_RECORD_BAD_NAME,			/* The record's name isn't in the
+										   names table or the name pool, or
+										   isn't a valid ingredient name	  */
+	INGREDIENT_RECORD_OUT_OF_MEMORY		/* A memory error occured			  */
+} IngredientRecordResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a new empty names table.
+ *
+ * @return The new table, or NULL if any error occured.
+ */
+IngredientRecordNames ingredientRecordNamesCreate(void);
+
+/*
+ * Destroy a given names table, deallocating all necessary memory.
+ *
+ * @param names The table to destroy.
+ */
+void ingredientRecordNamesDestroy(IngredientRecordNames names);
+
+/*
+ * Place in @id the id of a name, adding the name to the table if it isn't
+ * there yet. Adding names in the order of their ids rebuilds a saved table.
+ *
+ * @param names The table to add to.
+ * @param name The name to add.
+ * @param id The name's id will be placed here.
+ * @return Success or error code.
+ */
+IngredientRecordResult ingredientRecordNamesAdd(IngredientRecordNames names,
+											const char* name, uint32_t* id);
+
+/*
+ * Returns the name with the given id, or NULL if @names is NULL or has no
+ * such id. The string stays valid until the table is destroyed.
+ *
+ * @param names The table to read.
+ * @param id The name's id.
+ * @return The name.
+ */
+const char* ingredientRecordNamesGet(IngredientRecordNames names, uint32_t id);
+
+/*
+ * Returns the number of names in the table, or 0 if @names is NULL.
+ *
+ * @param names The table.
+ * @return The table's size.
+ */
+int ingredientRecordNamesSize(IngredientRecordNames names);
+
+/*
+ * Pack an ingredient into a record, adding its name to @names.
+ * Only valid ingredients (as accepted by ingredientInitialize) can be packed.
+ * @names may be NULL only with INGREDIENT_INTERNED_NAMES.
+ *
+ * @param names The table the record's name id comes from.
+ * @param ingredient The ingredient to pack.
+ * @param record The packed ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientRecordResult ingredientRecordPack(IngredientRecordNames names,
+							Ingredient ingredient, IngredientRecord* record);
+
+/*
+ * Unpack a record back into the ingredient it was packed from, given the
+ * table it was packed with.
+ * A record whose fields are out of their ranges, as one read from a damaged
+ * file may be, gives INGREDIENT_RECORD_BAD_INGREDIENT.
+ * With INGREDIENT_INTERNED_NAMES and a table, the name is interned, which may
+ * give INGREDIENT_RECORD_OUT_OF_MEMORY.
+ *
+ * @param names The table the record was packed with.
+ * @param record The record to unpack.
+ * @param ingredient The unpacked ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientRecordResult ingredientRecordUnpack(IngredientRecordNames names,
+							IngredientRecord record, Ingredient* ingredient);
+
+/*
+ * Pack @count ingredients into @records.
+ * If an ingredient can't be packed the function stops there, and the records
+ * from that index on are undefined.
+ *
+ * @param names The table the records' name ids come from.
+ * @param ingredients The ingredients to pack.
+ * @param count The number of ingredients.
+ * @param records An array of at least @count records to fill.
+ * @return Success or error code.
+ */
+IngredientRecordResult ingredientRecordPackArray(IngredientRecordNames names,
+		const Ingredient* ingredients, int count, IngredientRecord* records);
+
+/*
+ * Unpack @count records into @ingredients, stopping at the first record that
+ * can't be unpacked.
+ *
+ * @param names The table the records were packed with.
+ * @param records The records to unpack.
+ * @param count The number of records.
+ * @param ingredients An array of at least @count ingredients to fill.
+ * @return Success or error code.
+ */
+IngredientRecordResult ingredientRecordUnpackArray(IngredientRecordNames names,
+		const IngredientRecord* records, int count, Ingredient* ingredients);
+
+/*
+ * Field accessors. These read a packed record directly, so catalog scans
+ * don't need to unpack whole ingredients.
+ */
+KosherType ingredientRecordGetKosherType(IngredientRecord record);
+int ingredientRecordGetCalories(IngredientRecord record);
+int ingredientRecordGetHealth(IngredientRecord record);
+
+/*
+ * Returns the quality of the record's ingredient, as ingredientGetQuality
+ * would.
+ *
+ * @param record The record to get the quality of.
+ * @return The ingredient's quality.
+ */
+double ingredientRecordGetQuality(IngredientRecord record);
+
+#endif /* INGREDIENT_RECORD_H_ */
@@ -0,0 +1,236 @@
+#include "ingredient_record.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_DOUBLE_EQUALS(expr,expected) ASSERT(DOUBLE_EQUALS(expr, expected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, INGREDIENT_RECORD_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) \
+	ASSERT_EQUALS(expr, INGREDIENT_RECORD_NULL_ARGUMENT)
+#define ASSERT_BAD_INGREDIENT(expr) \
+	ASSERT_EQUALS(expr, INGREDIENT_RECORD_BAD_INGREDIENT)
+
+#define KOSHER_SHIFT \
+	(INGREDIENT_RECORD_CALORIES_BITS + INGREDIENT_RECORD_HEALTH_BITS)
+
+static bool testAccessors() {
+	IngredientRecord record;
+	record.cost = 1.25;
+	record.name = 0;
+	record.attributes = (uint32_t)(30 - INGREDIENT_MIN_CALORIES) |
+		(uint32_t)(9 - INGREDIENT_MIN_HEALTH) << INGREDIENT_RECORD_CALORIES_BITS |
+		(uint32_t)MILKY << KOSHER_SHIFT;
+
+	ASSERT_EQUALS(sizeof(IngredientRecord), 16);
+	ASSERT_EQUALS(ingredientRecordGetKosherType(record), MILKY);
+	ASSERT_EQUALS(ingredientRecordGetCalories(record), 30);
+	ASSERT_EQUALS(ingredientRecordGetHealth(record), 9);
+	Ingredient tomato = ingredientInitialize("Tomato", MILKY, 30, 9, 1.25, NULL);
+	ASSERT_DOUBLE_EQUALS(ingredientRecordGetQuality(record),
+						ingredientGetQuality(tomato));
+	return true;
+}
+
+static bool testNames() {
+	IngredientRecordNames names = ingredientRecordNamesCreate();
+	uint32_t tomato, potato, again;
+	ASSERT_NULL_ARGUMENT(ingredientRecordNamesAdd(NULL, "Tomato", &tomato));
+	ASSERT_NULL_ARGUMENT(ingredientRecordNamesAdd(names, NULL, &tomato));
+	ASSERT_NULL_ARGUMENT(ingredientRecordNamesAdd(names, "Tomato", NULL));
+
+	ASSERT_SUCCESS(ingredientRecordNamesAdd(names, "Tomato", &tomato));
+	ASSERT_SUCCESS(ingredientRecordNamesAdd(names, "Potato", &potato));
+	ASSERT_SUCCESS(ingredientRecordNamesAdd(names, "Tomato", &again));
+	ASSERT_EQUALS(tomato, 0);
+	ASSERT_EQUALS(potato, 1);
+	ASSERT_EQUALS(again, tomato);
+	ASSERT_EQUALS(ingredientRecordNamesSize(names), 2);
+	ASSERT_EQUALS(strcmp(ingredientRecordNamesGet(names, potato), "Potato"), 0);
+	ASSERT_EQUALS(ingredientRecordNamesGet(names, 2), NULL);
+	ASSERT_EQUALS(ingredientRecordNamesGet(NULL, 0), NULL);
+	ASSERT_EQUALS(ingredientRecordNamesSize(NULL), 0);
+
+	char name[32];
+	for (int i=0;i<1000;i++) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_SUCCESS(ingredientRecordNamesAdd(names, name, &again));
+		ASSERT_EQUALS(again, (uint32_t)i + 2);
+	}
+	ASSERT_EQUALS(strcmp(ingredientRecordNamesGet(names, 501), "Ingredient 499"),
+				0);
+
+	ingredientRecordNamesDestroy(names);
+	ingredientRecordNamesDestroy(NULL);
+	return true;
+}
+
+static bool testPack() {
+	IngredientRecordNames names = ingredientRecordNamesCreate();
+	Ingredient tomato = ingredientInitialize("Tomato", PARVE, 30, 9, 1.25, NULL);
+	IngredientRecord record;
+
+	ASSERT_NULL_ARGUMENT(ingredientRecordPack(names, tomato, NULL));
+#ifndef INGREDIENT_INTERNED_NAMES
+	ASSERT_NULL_ARGUMENT(ingredientRecordPack(NULL, tomato, &record));
+#endif
+	ASSERT_SUCCESS(ingredientRecordPack(names, tomato, &record));
+	ASSERT_EQUALS(record.name, 0);
+	ASSERT_EQUALS(ingredientRecordGetKosherType(record), PARVE);
+	ASSERT_EQUALS(ingredientRecordGetCalories(record), 30);
+	ASSERT_EQUALS(ingredientRecordGetHealth(record), 9);
+	ASSERT_DOUBLE_EQUALS(ingredientRecordGetQuality(record),
+						ingredientGetQuality(tomato));
+
+	Ingredient bad = tomato;
+	bad.calories = INGREDIENT_MAX_CALORIES + 1;
+	ASSERT_BAD_INGREDIENT(ingredientRecordPack(names, bad, &record));
+	bad = tomato;
+	bad.health = -1;
+	ASSERT_BAD_INGREDIENT(ingredientRecordPack(names, bad, &record));
+	bad = tomato;
+	bad.kosherType = (KosherType)INGREDIENT_KOSHER_TYPE_VALUES;
+	ASSERT_BAD_INGREDIENT(ingredientRecordPack(names, bad, &record));
+	bad = tomato;
+	bad.cost = -1;
+	ASSERT_BAD_INGREDIENT(ingredientRecordPack(names, bad, &record));
+	ASSERT_EQUALS(ingredientRecordNamesSize(names), 1);
+
+	ingredientRecordNamesDestroy(names);
+	return true;
+}
+
+static bool testUnpack() {
+	IngredientRecordNames names = ingredientRecordNamesCreate();
+	Ingredient ingredient;
+	IngredientRecord record;
+
+	for (int kosher=0;kosher<INGREDIENT_KOSHER_TYPE_VALUES;kosher++) {
+		for (int calories=INGREDIENT_MIN_CALORIES;
+				calories<=INGREDIENT_MAX_CALORIES;calories+=97) {
+			for (int health=INGREDIENT_MIN_HEALTH;
+					health<=INGREDIENT_MAX_HEALTH;health++) {
+				Ingredient original = ingredientInitialize("Potato",
+						(KosherType)kosher, calories, health, calories*0.5, NULL);
+				ASSERT_SUCCESS(ingredientRecordPack(names, original, &record));
+				ASSERT_SUCCESS(ingredientRecordUnpack(names, record,
+													&ingredient));
+				ASSERT_EQUALS(strcmp(ingredientPeekName(&ingredient), "Potato"), 0);
+				ASSERT_EQUALS(ingredient.kosherType, original.kosherType);
+				ASSERT_EQUALS(ingredient.calories, original.calories);
+				ASSERT_EQUALS(ingredient.health, original.health);
+				ASSERT_EQUALS(ingredient.cost, original.cost);
+			}
+		}
+	}
+
+	ASSERT_NULL_ARGUMENT(ingredientRecordUnpack(names, record, NULL));
+	record.name = (uint32_t)-1;
+	ASSERT_EQUALS(ingredientRecordUnpack(names, record, &ingredient),
+				INGREDIENT_RECORD_BAD_NAME);
+	uint32_t id;
+	ASSERT_SUCCESS(ingredientRecordNamesAdd(names, "", &id));
+	record.name = id;
+	ASSERT_EQUALS(ingredientRecordUnpack(names, record, &ingredient),
+				INGREDIENT_RECORD_BAD_NAME);
+
+	/* fields that fit their bits but are out of range are rejected */
+	Ingredient tomato = ingredientInitialize("Tomato", PARVE, 30, 9, 1, NULL);
+	IngredientRecord valid;
+	ASSERT_SUCCESS(ingredientRecordPack(names, tomato, &valid));
+	uint32_t calorieBits = (UINT32_C(1) << INGREDIENT_RECORD_CALORIES_BITS) - 1;
+	record = valid;
+	record.attributes |= (uint32_t)3 << KOSHER_SHIFT;
+	ASSERT_BAD_INGREDIENT(ingredientRecordUnpack(names, record, &ingredient));
+	record = valid;
+	record.attributes |= calorieBits;
+	ASSERT_BAD_INGREDIENT(ingredientRecordUnpack(names, record, &ingredient));
+	record = valid;
+	record.attributes |= (uint32_t)15 << INGREDIENT_RECORD_CALORIES_BITS;
+	ASSERT_BAD_INGREDIENT(ingredientRecordUnpack(names, record, &ingredient));
+	record = valid;
+	record.attributes |= UINT32_C(1) << 31;
+	ASSERT_BAD_INGREDIENT(ingredientRecordUnpack(names, record, &ingredient));
+	record = valid;
+	record.cost = -1;
+	ASSERT_BAD_INGREDIENT(ingredientRecordUnpack(names, record, &ingredient));
+
+	ingredientRecordNamesDestroy(names);
+	return true;
+}
+
+static bool testArrays() {
+	IngredientRecordNames names = ingredientRecordNamesCreate();
+	Ingredient ingredients[3] = {
+		ingredientInitialize("Tomato", PARVE, 30, 9, 1, NULL),
+		ingredientInitialize("Butter", MILKY, 700, 1, 5, NULL),
+		ingredientInitialize("Steak", MEATY, 250, 6, 40, NULL)
+	};
+	IngredientRecord records[3];
+	Ingredient unpacked[3];
+
+	ASSERT_NULL_ARGUMENT(ingredientRecordPackArray(names, NULL, 3, records));
+	ASSERT_NULL_ARGUMENT(ingredientRecordUnpackArray(names, records, 3, NULL));
+	ASSERT_SUCCESS(ingredientRecordPackArray(names, ingredients, 3, records));
+	ASSERT_SUCCESS(ingredientRecordUnpackArray(names, records, 3, unpacked));
+	for (int i=0;i<3;i++) {
+		ASSERT_EQUALS(records[i].name, (uint32_t)i);
+		ASSERT_EQUALS(strcmp(ingredientPeekName(&unpacked[i]),
+							ingredientPeekName(&ingredients[i])), 0);
+		ASSERT_EQUALS(unpacked[i].kosherType, ingredients[i].kosherType);
+		ASSERT_EQUALS(unpacked[i].calories, ingredients[i].calories);
+		ASSERT_EQUALS(unpacked[i].health, ingredients[i].health);
+		ASSERT_EQUALS(unpacked[i].cost, ingredients[i].cost);
+	}
+
+	ingredients[1].health = INGREDIENT_MAX_HEALTH + 1;
+	ASSERT_BAD_INGREDIENT(ingredientRecordPackArray(names, ingredients, 3,
+													records));
+	ingredientRecordNamesDestroy(names);
+	return true;
+}
+
+#ifdef INGREDIENT_INTERNED_NAMES
+static bool testPoolIds() {
+	Ingredient tomato = ingredientInitialize("Tomato", PARVE, 30, 9, 1.25, NULL);
+	IngredientRecord record;
+	Ingredient ingredient;
+
+	ASSERT_SUCCESS(ingredientRecordPack(NULL, tomato, &record));
+	ASSERT_EQUALS(record.name, tomato.name.id);
+	ASSERT_SUCCESS(ingredientRecordUnpack(NULL, record, &ingredient));
+	ASSERT_EQUALS(ingredientHaveSameName(ingredient, tomato), true);
+	record.name = (uint32_t)-1;
+	ASSERT_EQUALS(ingredientRecordUnpack(NULL, record, &ingredient),
+				INGREDIENT_RECORD_BAD_NAME);
+	return true;
+}
+#endif
+
+int main() {
+	RUN_TEST(testAccessors);
+	RUN_TEST(testNames);
+	RUN_TEST(testPack);
+	RUN_TEST(testUnpack);
+	RUN_TEST(testArrays);
+#ifdef INGREDIENT_INTERNED_NAMES
+	RUN_TEST(testPoolIds);
+#endif
+	return 0;
+}
@@ -0,0 +1,474 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+#include "ingredient_skyline.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return INGREDIENT_SKYLINE_NULL_ARGUMENT;	}
+
+#define CALORIE_VALUES (INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES+1)
+#define HEALTH_VALUES (INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH+1)
+
+#define NO_ITEM INGREDIENT_SKYLINE_NO_ID
+
+/*
+ * Kosher type, calories and health are small bounded integers, so the index
+ * splits the catalog into one cell per (kosher type, health, calories)
+ * triple. For every kosher type and health value a min segment tree over
+ * calories holds the cheapest ingredient of each cell.
+ *
+ * The cheapest ingredient better than X is the cheapest of the prefix minima
+ * over calories < X.calories of the trees of every health value > X.health,
+ * if it costs less than X. X is dominated iff there is one. That is at most
+ * KOSHER_TYPE_VALUES*HEALTH_VALUES queries of O(log CALORIE_VALUES) each,
+ * whatever the size of the catalog.
+ *
+ * The cells and the tree of a (kosher type, health) pair form a bucket, which
+ * is allocated when its first ingredient is placed. An empty index holds no
+ * buckets, and a catalog only pays for the pairs it uses. A missing bucket
+ * answers every query with no ingredient.
+ */
+typedef struct skyline_item_t {
+	Ingredient ingredient;
+	int position;		/* Index in the item's cell, NO_ITEM if free	  */
+	int nextFree;
+} SkylineItem;
+
+typedef struct skyline_cell_t {
+	int* items;
+	int size;
+	int capacity;
+} SkylineCell;
+
+typedef struct skyline_tree_t {
+	double* costs;
+	int* items;
+} SkylineTree;
+
+typedef struct skyline_bucket_t {
+	SkylineCell cells[CALORIE_VALUES];
+	SkylineTree tree;
+} SkylineBucket;
+
+struct ingredient_skyline_t {
+	SkylineItem* items;
+	int itemCount;
+	int itemCapacity;
+	int firstFree;
+	int size;
+	int leaves;
+	SkylineBucket* buckets[INGREDIENT_KOSHER_TYPE_VALUES][HEALTH_VALUES];
+};
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+static bool isValidIngredient(Ingredient ingredient) {
+	return (ingredient.kosherType >= 0 &&
+			ingredient.kosherType < INGREDIENT_KOSHER_TYPE_VALUES &&
+			ingredient.calories >= INGREDIENT_MIN_CALORIES &&
+			ingredient.calories <= INGREDIENT_MAX_CALORIES &&
+			ingredient.health >= INGREDIENT_MIN_HEALTH &&
+			ingredient.health <= INGREDIENT_MAX_HEALTH &&
+			isfinite(ingredient.cost) && ingredient.cost >= 0);
+}
+
+static SkylineBucket** itemBucket(IngredientSkyline skyline,
+								Ingredient ingredient) {
+	return &skyline->buckets[ingredient.kosherType]
+							[ingredient.health-INGREDIENT_MIN_HEALTH];
+}
+
+static SkylineCell* itemCell(IngredientSkyline skyline, Ingredient ingredient) {
+	return &(*itemBucket(skyline,ingredient))->cells[ingredient.calories-
+												INGREDIENT_MIN_CALORIES];
+}
+
+static bool isLiveItem(IngredientSkyline skyline, int id) {
+	return (id >= 0 && id < skyline->itemCount &&
+			skyline->items[id].position != NO_ITEM);
+}
+
+static void setNode(SkylineTree* tree, int node, double cost, int item) {
+	tree->costs[node] = cost;
+	tree->items[node] = item;
+}
+
+static void pullNode(SkylineTree* tree, int node) {
+	int child = 2*node;
+	if (tree->costs[child+1] < tree->costs[child]) {
+		child++;
+	}
+	setNode(tree,node,tree->costs[child],tree->items[child]);
+}
+
+static void destroyBucket(SkylineBucket* bucket) {
+	if (bucket == NULL) {
+		return;
+	}
+	for (int i=0;i<CALORIE_VALUES;i++) {
+		free(bucket->cells[i].items);
+	}
+	free(bucket->tree.costs);
+	free(bucket->tree.items);
+	free(bucket);
+}
+
+static SkylineBucket* createBucket(int leaves) {
+	SkylineBucket* bucket = (SkylineBucket*)malloc(sizeof(*bucket));
+	if (bucket == NULL) {
+		return NULL;
+	}
+	for (int i=0;i<CALORIE_VALUES;i++) {
+		bucket->cells[i].items = NULL;
+		bucket->cells[i].size = 0;
+		bucket->cells[i].capacity = 0;
+	}
+	bucket->tree.costs = (double*)malloc(sizeof(double)*2*leaves);
+	bucket->tree.items = (int*)malloc(sizeof(int)*2*leaves);
+	if (bucket->tree.costs == NULL || bucket->tree.items == NULL) {
+		destroyBucket(bucket);
+		return NULL;
+	}
+	for (int node=1;node<2*leaves;node++) {
+		setNode(&bucket->tree,node,INFINITY,NO_ITEM);
+	}
+	return bucket;
+}
+
+static void computeLeaf(IngredientSkyline skyline, SkylineBucket* bucket,
+						int calories) {
+	SkylineCell* cell = &bucket->cells[calories];
+	SkylineTree* tree = &bucket->tree;
+	int leaf = skyline->leaves + calories;
+	setNode(tree,leaf,INFINITY,NO_ITEM);
+	for (int i=0;i<cell->size;i++) {
+		double cost = skyline->items[cell->items[i]].ingredient.cost;
+		if (cost < tree->costs[leaf]) {
+			setNode(tree,leaf,cost,cell->items[i]);
+		}
+	}
+}
+
+static void updateLeaf(IngredientSkyline skyline, Ingredient ingredient) {
+	SkylineBucket* bucket = *itemBucket(skyline,ingredient);
+	int calories = ingredient.calories-INGREDIENT_MIN_CALORIES;
+	computeLeaf(skyline,bucket,calories);
+	SkylineTree* tree = &bucket->tree;
+	for (int node=(skyline->leaves+calories)/2;node>=1;node/=2) {
+		pullNode(tree,node);
+	}
+}
+
+/*
+ * The cheapest ingredient with the given kosher type and health and calories
+ * in [0, lastCalories]. Its cost is INFINITY if there is none.
+ */
+static int cheapestInPrefix(IngredientSkyline skyline, int kosherType,
+						int health, int lastCalories, double* cost) {
+	int item = NO_ITEM;
+	*cost = INFINITY;
+	if (skyline->buckets[kosherType][health] == NULL) {
+		return item;
+	}
+	SkylineTree* tree = &skyline->buckets[kosherType][health]->tree;
+	for (int left=skyline->leaves, right=skyline->leaves+lastCalories+1;
+			left<right;left/=2, right/=2) {
+		if (left & 1) {
+			if (tree->costs[left] < *cost) {
+				*cost = tree->costs[left];
+				item = tree->items[left];
+			}
+			left++;
+		}
+		if (right & 1) {
+			right--;
+			if (tree->costs[right] < *cost) {
+				*cost = tree->costs[right];
+				item = tree->items[right];
+			}
+		}
+	}
+	return item;
+}
+
+/*
+ * The cheapest ingredient of one of the allowed kosher types that is better
+ * than @ingredient, or NO_ITEM if there is none.
+ */
+static int cheapestBetter(IngredientSkyline skyline, Ingredient ingredient,
+						const bool* allowedKosherTypes) {
+	if (ingredient.calories <= INGREDIENT_MIN_CALORIES ||
+			ingredient.health >= INGREDIENT_MAX_HEALTH) {
+		return NO_ITEM;
+	}
+	int lastCalories = ingredient.calories-INGREDIENT_MIN_CALORIES-1;
+	if (lastCalories > CALORIE_VALUES-1) {
+		lastCalories = CALORIE_VALUES-1;
+	}
+	int firstHealth = 0;
+	if (ingredient.health >= INGREDIENT_MIN_HEALTH) {
+		firstHealth = ingredient.health-INGREDIENT_MIN_HEALTH+1;
+	}
+	int cheapest = NO_ITEM;
+	double cheapestCost = ingredient.cost;
+	double cost;
+	for (int kosherType=0;kosherType<INGREDIENT_KOSHER_TYPE_VALUES;kosherType++) {
+		if (allowedKosherTypes != NULL && !allowedKosherTypes[kosherType]) {
+			continue;
+		}
+		for (int health=firstHealth;health<HEALTH_VALUES;health++) {
+			int item = cheapestInPrefix(skyline,kosherType,health,
+										lastCalories,&cost);
+			if (cost < cheapestCost) {
+				cheapestCost = cost;
+				cheapest = item;
+			}
+		}
+	}
+	return cheapest;
+}
+
+static bool skylineDominates(IngredientSkyline skyline, Ingredient ingredient) {
+	return cheapestBetter(skyline,ingredient,NULL) != NO_ITEM;
+}
+
+static bool addToCell(SkylineCell* cell, int id, int* position) {
+	if (cell->size == cell->capacity) {
+		int capacity = (cell->capacity == 0) ? 4 : cell->capacity*2;
+		int* items = (int*)realloc(cell->items,sizeof(int)*capacity);
+		if (items == NULL) {
+			return false;
+		}
+		cell->items = items;
+		cell->capacity = capacity;
+	}
+	*position = cell->size;
+	cell->items[cell->size++] = id;
+	return true;
+}
+
+/* Takes a free id, growing the item array if needed. */
+static int allocateItem(IngredientSkyline skyline) {
+	if (skyline->firstFree != NO_ITEM) {
+		int id = skyline->firstFree;
+		skyline->firstFree = skyline->items[id].nextFree;
+		return id;
+	}
+	if (skyline->itemCount == skyline->itemCapacity) {
+		int capacity = (skyline->itemCapacity == 0) ? 16 :
+												skyline->itemCapacity*2;
+		SkylineItem* items = (SkylineItem*)realloc(skyline->items,
+												sizeof(SkylineItem)*capacity);
+		if (items == NULL) {
+			return NO_ITEM;
+		}
+		skyline->items = items;
+		skyline->itemCapacity = capacity;
+	}
+	skyline->items[skyline->itemCount].position = NO_ITEM;
+	return skyline->itemCount++;
+}
+
+static void freeItem(IngredientSkyline skyline, int id) {
+	skyline->items[id].position = NO_ITEM;
+	skyline->items[id].nextFree = skyline->firstFree;
+	skyline->firstFree = id;
+}
+
+/* Places a new ingredient in its cell, without updating the trees. */
+static IngredientSkylineResult placeItem(IngredientSkyline skyline,
+										Ingredient ingredient, int* id) {
+	if (!isValidIngredient(ingredient)) {
+		return INGREDIENT_SKYLINE_BAD_INGREDIENT;
+	}
+	SkylineBucket** bucket = itemBucket(skyline,ingredient);
+	if (*bucket == NULL) {
+		*bucket = createBucket(skyline->leaves);
+		if (*bucket == NULL) {
+			return INGREDIENT_SKYLINE_OUT_OF_MEMORY;
+		}
+	}
+	int newId = allocateItem(skyline);
+	if (newId == NO_ITEM) {
+		return INGREDIENT_SKYLINE_OUT_OF_MEMORY;
+	}
+	SkylineItem* item = &skyline->items[newId];
+	item->ingredient = ingredient;
+	if (!addToCell(itemCell(skyline,ingredient),newId,&item->position)) {
+		freeItem(skyline,newId);
+		return INGREDIENT_SKYLINE_OUT_OF_MEMORY;
+	}
+	skyline->size++;
+	*id = newId;
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+IngredientSkyline ingredientSkylineCreate(void) {
+	IngredientSkyline skyline = (IngredientSkyline)malloc(sizeof(*skyline));
+	if (skyline == NULL) {
+		return NULL;
+	}
+	skyline->items = NULL;
+	skyline->itemCount = 0;
+	skyline->itemCapacity = 0;
+	skyline->firstFree = NO_ITEM;
+	skyline->size = 0;
+	skyline->leaves = 1;
+	while (skyline->leaves < CALORIE_VALUES) {
+		skyline->leaves *= 2;
+	}
+	SkylineBucket** buckets = &skyline->buckets[0][0];
+	for (int i=0;i<INGREDIENT_KOSHER_TYPE_VALUES*HEALTH_VALUES;i++) {
+		buckets[i] = NULL;
+	}
+	return skyline;
+}
+
+IngredientSkyline ingredientSkylineCreateFrom(const Ingredient* ingredients,
+												int count) {
+	if (ingredients == NULL || count < 0) {
+		return NULL;
+	}
+	IngredientSkyline skyline = ingredientSkylineCreate();
+	if (skyline == NULL) {
+		return NULL;
+	}
+	int id;
+	for (int i=0;i<count;i++) {
+		if (placeItem(skyline,ingredients[i],&id) != INGREDIENT_SKYLINE_SUCCESS) {
+			ingredientSkylineDestroy(skyline);
+			return NULL;
+		}
+	}
+	for (int kosherType=0;kosherType<INGREDIENT_KOSHER_TYPE_VALUES;kosherType++) {
+		for (int health=0;health<HEALTH_VALUES;health++) {
+			SkylineBucket* bucket = skyline->buckets[kosherType][health];
+			if (bucket == NULL) {
+				continue;
+			}
+			for (int calories=0;calories<CALORIE_VALUES;calories++) {
+				computeLeaf(skyline,bucket,calories);
+			}
+			for (int node=skyline->leaves-1;node>=1;node--) {
+				pullNode(&bucket->tree,node);
+			}
+		}
+	}
+	return skyline;
+}
+
+void ingredientSkylineDestroy(IngredientSkyline skyline) {
+	if (skyline == NULL) {
+		return;
+	}
+	SkylineBucket** buckets = &skyline->buckets[0][0];
+	for (int i=0;i<INGREDIENT_KOSHER_TYPE_VALUES*HEALTH_VALUES;i++) {
+		destroyBucket(buckets[i]);
+	}
+	free(skyline->items);
+	free(skyline);
+}
+
+IngredientSkylineResult ingredientSkylineInsert(IngredientSkyline skyline,
+										Ingredient ingredient, int* id) {
+	CHECK_NULL_ARG(skyline)
+	int newId;
+	IngredientSkylineResult result = placeItem(skyline,ingredient,&newId);
+	if (result != INGREDIENT_SKYLINE_SUCCESS) {
+		return result;
+	}
+	updateLeaf(skyline,ingredient);
+	if (id != NULL) {
+		*id = newId;
+	}
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+IngredientSkylineResult ingredientSkylineRemove(IngredientSkyline skyline,
+												int id) {
+	CHECK_NULL_ARG(skyline)
+	if (!isLiveItem(skyline,id)) {
+		return INGREDIENT_SKYLINE_NOT_FOUND;
+	}
+	Ingredient ingredient = skyline->items[id].ingredient;
+	SkylineCell* cell = itemCell(skyline,ingredient);
+	int position = skyline->items[id].position;
+	int moved = cell->items[--cell->size];
+	cell->items[position] = moved;
+	skyline->items[moved].position = position;
+	freeItem(skyline,id);
+	skyline->size--;
+	updateLeaf(skyline,ingredient);
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+IngredientSkylineResult ingredientSkylineGet(IngredientSkyline skyline,
+										int id, Ingredient* ingredient) {
+	CHECK_NULL_ARG(skyline)
+	CHECK_NULL_ARG(ingredient)
+	if (!isLiveItem(skyline,id)) {
+		return INGREDIENT_SKYLINE_NOT_FOUND;
+	}
+	*ingredient = skyline->items[id].ingredient;
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+int ingredientSkylineSize(IngredientSkyline skyline) {
+	if (skyline == NULL) {
+		return 0;
+	}
+	return skyline->size;
+}
+
+IngredientSkylineResult ingredientSkylineIsDominated(IngredientSkyline skyline,
+									Ingredient ingredient, bool* isDominated) {
+	CHECK_NULL_ARG(skyline)
+	CHECK_NULL_ARG(isDominated)
+	*isDominated = skylineDominates(skyline,ingredient);
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+IngredientSkylineResult ingredientSkylineGetFrontier(IngredientSkyline skyline,
+												int* ids, int* count) {
+	CHECK_NULL_ARG(skyline)
+	CHECK_NULL_ARG(ids)
+	CHECK_NULL_ARG(count)
+	*count = 0;
+	for (int id=0;id<skyline->itemCount;id++) {
+		if (isLiveItem(skyline,id) &&
+				!skylineDominates(skyline,skyline->items[id].ingredient)) {
+			ids[(*count)++] = id;
+		}
+	}
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+IngredientSkylineResult ingredientSkylineFindSubstitute(
+		IngredientSkyline skyline, Ingredient ingredient,
+		const bool* allowedKosherTypes, int* id) {
+	CHECK_NULL_ARG(skyline)
+	CHECK_NULL_ARG(id)
+	*id = cheapestBetter(skyline,ingredient,allowedKosherTypes);
+	if (*id == NO_ITEM) {
+		return INGREDIENT_SKYLINE_NOT_FOUND;
+	}
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
+
+IngredientSkylineResult ingredientSkylineFindSubstitutes(
+		IngredientSkyline skyline, const Ingredient* ingredients, int count,
+		const bool* allowedKosherTypes, int* ids) {
+	CHECK_NULL_ARG(skyline)
+	CHECK_NULL_ARG(ingredients)
+	CHECK_NULL_ARG(ids)
+	for (int i=0;i<count;i++) {
+		ids[i] = cheapestBetter(skyline,ingredients[i],allowedKosherTypes);
+	}
+	return INGREDIENT_SKYLINE_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*
+ * ingredient_skyline.h
+ *
+ * A Pareto skyline index over a catalog of ingredients.
+ * An ingredient is dominated if some ingredient in the index is better than
+ * it, in the sense of ingredientIsBetter: cheaper, with less calories and
+ * healthier. The ingredients that no other ingredient dominates form the
+ * frontier of the catalog.
+ */
+
+#ifndef INGREDIENT_SKYLINE_H_
+#define INGREDIENT_SKYLINE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Ingredient Skyline Struct
+ ******************************************************************************/
+typedef struct ingredient_skyline_t* IngredientSkyline;
+
+/* Never the id of an ingredient in the index */
+#define INGREDIENT_SKYLINE_NO_ID (-1)
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	INGREDIENT_SKYLINE_SUCCESS,			/* Operation succeeded 			  */
+	INGREDIENT_SKYLINE_NULL_ARGUMENT,	/* A NULL argument was passed 	  */
+	INGREDIENT_SKYLINE_BAD_INGREDIENT,	/* An ingredient with an invalid
+										   kosher type, calories, health
+										   or cost was passed			  */
+	INGREDIENT_SKYLINE_NOT_FOUND,		/* No ingredient has the given id */
+	INGREDIENT_SKYLINE_OUT_OF_MEMORY	/* A memory error occured		  */
+} IngredientSkylineResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a new empty skyline index.
+ *
+ * @return The new index, or NULL if any error occured.
+ */
+IngredientSkyline ingredientSkylineCreate(void);
+
+/*
+ * Create a skyline index holding the given ingredients, in a single pass that
+ * is cheaper than inserting them one by one.
+ * The ingredient at @ingredients[i] gets the id i.
+ *
+ * @param ingredients The ingredients to index.
+ * @param count The number of ingredients.
+ * @return The new index, or NULL if any of the ingredients is invalid or any
+ * other error occured.
+ */
+IngredientSkyline ingredientSkylineCreateFrom(const Ingredient* ingredients,
+												int count);
+
+/*
+ * Destroy a given skyline index, deallocating all necessary memory.
+ *
+ * @param skyline The index to destroy.
+ */
+void ingredientSkylineDestroy(IngredientSkyline skyline);
+
+/*
+ * Add an ingredient to the index.
+ * The ingredient's id is placed in @id if not NULL. Ids of removed
+ * ingredients may be reused.
+ *
+ * @param skyline The index to add to.
+ * @param ingredient The ingredient to add.
+ * @param id The ingredient's id will be placed here if not NULL.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineInsert(IngredientSkyline skyline,
+										Ingredient ingredient, int* id);
+
+/*
+ * Remove an ingredient from the index, using the ingredient's id.
+ *
+ * @param skyline The index to remove from.
+ * @param id The ingredient's id.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineRemove(IngredientSkyline skyline,
+												int id);
+
+/*
+ * Place the ingredient with a given id in @ingredient.
+ *
+ * @param skyline The index to read from.
+ * @param id The ingredient's id.
+ * @param ingredient The ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineGet(IngredientSkyline skyline,
+										int id, Ingredient* ingredient);
+
+/*
+ * Returns the number of ingredients in the index, or 0 if @skyline is NULL.
+ *
+ * @param skyline The index.
+ * @return The number of ingredients.
+ */
+int ingredientSkylineSize(IngredientSkyline skyline);
+
+/*
+ * Test if any ingredient in the index is better than a given ingredient.
+ * The given ingredient doesn't have to be in the index.
+ *
+ * @param skyline The index to search.
+ * @param ingredient The ingredient to test.
+ * @param isDominated The result will be placed here.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineIsDominated(IngredientSkyline skyline,
+									Ingredient ingredient, bool* isDominated);
+
+/*
+ * List the ids of the ingredients no other ingredient in the index is better
+ * than.
+ *
+ * @param skyline The index.
+ * @param ids The ids will be placed here. Must have room for the index's size.
+ * @param count The number of ids placed in @ids will be placed here.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineGetFrontier(IngredientSkyline skyline,
+												int* ids, int* count);
+
+/*
+ * Find the cheapest ingredient in the index that is better than a given
+ * ingredient, among the ingredients of the allowed kosher types.
+ *
+ * @allowedKosherTypes[t] tells whether ingredients of kosher type t may be
+ * returned, for example as filled by dishGetAllowedKosherTypes. If it's NULL,
+ * all kosher types are allowed.
+ * If no ingredient qualifies, INGREDIENT_SKYLINE_NOT_FOUND is returned and
+ * @id will hold INGREDIENT_SKYLINE_NO_ID.
+ *
+ * @param skyline The index to search.
+ * @param ingredient The ingredient to substitute.
+ * @param allowedKosherTypes The allowed kosher types, or NULL.
+ * @param id The substitute's id will be placed here.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineFindSubstitute(
+		IngredientSkyline skyline, Ingredient ingredient,
+		const bool* allowedKosherTypes, int* id);
+
+/*
+ * Find substitutes for many ingredients at once, as
+ * ingredientSkylineFindSubstitute would.
+ * ids[i] will hold the id of the substitute for ingredients[i], or
+ * INGREDIENT_SKYLINE_NO_ID if it has none.
+ *
+ * @param skyline The index to search.
+ * @param ingredients The ingredients to substitute.
+ * @param count The number of ingredients.
+ * @param allowedKosherTypes The allowed kosher types, or NULL.
+ * @param ids An array with room for @count ids.
+ * @return Success or error code.
+ */
+IngredientSkylineResult ingredientSkylineFindSubstitutes(
+		IngredientSkyline skyline, const Ingredient* ingredients, int count,
+		const bool* allowedKosherTypes, int* ids);
+
+#endif /* INGREDIENT_SKYLINE_H_ */
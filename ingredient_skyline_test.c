@@ -0,0 +1,218 @@
+#include "ingredient_skyline.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+#define ASSERT_TRUE(expr) ASSERT_EQUALS(expr, true)
+#define ASSERT_FALSE(expr) ASSERT_EQUALS(expr, false)
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, INGREDIENT_SKYLINE_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) ASSERT_EQUALS(expr, INGREDIENT_SKYLINE_NULL_ARGUMENT)
+#define ASSERT_NOT_FOUND(expr) ASSERT_EQUALS(expr, INGREDIENT_SKYLINE_NOT_FOUND)
+
+#define CATALOG_SIZE 500
+
+static unsigned int seed = 1;
+
+static int nextRandom(int bound) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8) % bound;
+}
+
+static Ingredient randomIngredient() {
+	return ingredientInitialize("Random", nextRandom(INGREDIENT_KOSHER_TYPE_VALUES),
+			nextRandom(INGREDIENT_MAX_CALORIES + 1),
+			nextRandom(INGREDIENT_MAX_HEALTH + 1), nextRandom(100) * 0.5, NULL);
+}
+
+static bool bruteForceDominated(const Ingredient* catalog, const bool* live,
+								int size, Ingredient ingredient) {
+	for (int i = 0; i < size; i++) {
+		if (live[i] && ingredientIsBetter(catalog[i], ingredient)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool testInsertAndRemove() {
+	IngredientSkyline skyline = ingredientSkylineCreate();
+	ASSERT_NOT_EQUALS(skyline, NULL);
+	Ingredient ing1 = ingredientInitialize("Tomato", PARVE, 10, 10, 5, NULL);
+	Ingredient ing2 = ingredientInitialize("Potato", PARVE, 20, 8, 10, NULL);
+	Ingredient bad = ing1;
+	bad.calories = INGREDIENT_MAX_CALORIES + 1;
+	Ingredient result;
+	int id1, id2;
+	bool isDominated;
+
+	ASSERT_NULL_ARGUMENT(ingredientSkylineInsert(NULL, ing1, &id1));
+	ASSERT_EQUALS(ingredientSkylineInsert(skyline, bad, &id1),
+					INGREDIENT_SKYLINE_BAD_INGREDIENT);
+	ASSERT_SUCCESS(ingredientSkylineInsert(skyline, ing1, &id1));
+	ASSERT_SUCCESS(ingredientSkylineInsert(skyline, ing2, &id2));
+	ASSERT_EQUALS(ingredientSkylineSize(skyline), 2);
+	ASSERT_SUCCESS(ingredientSkylineGet(skyline, id2, &result));
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&result), "Potato"), 0);
+
+	ASSERT_SUCCESS(ingredientSkylineIsDominated(skyline, ing2, &isDominated));
+	ASSERT_TRUE(isDominated);
+	ASSERT_SUCCESS(ingredientSkylineIsDominated(skyline, ing1, &isDominated));
+	ASSERT_FALSE(isDominated);
+
+	ASSERT_SUCCESS(ingredientSkylineRemove(skyline, id1));
+	ASSERT_NOT_FOUND(ingredientSkylineRemove(skyline, id1));
+	ASSERT_NOT_FOUND(ingredientSkylineGet(skyline, id1, &result));
+	ASSERT_NOT_FOUND(ingredientSkylineRemove(skyline, 1000));
+	ASSERT_SUCCESS(ingredientSkylineIsDominated(skyline, ing2, &isDominated));
+	ASSERT_FALSE(isDominated);
+	ASSERT_EQUALS(ingredientSkylineSize(skyline), 1);
+
+	ingredientSkylineDestroy(skyline);
+	return true;
+}
+
+static bool testMatchesIsBetter() {
+	Ingredient catalog[CATALOG_SIZE];
+	bool live[CATALOG_SIZE];
+	for (int i = 0; i < CATALOG_SIZE; i++) {
+		catalog[i] = randomIngredient();
+		live[i] = true;
+	}
+	IngredientSkyline skyline = ingredientSkylineCreateFrom(catalog,
+															CATALOG_SIZE);
+	ASSERT_NOT_EQUALS(skyline, NULL);
+	bool isDominated;
+
+	for (int round = 0; round < 4; round++) {
+		for (int i = 0; i < CATALOG_SIZE; i++) {
+			ASSERT_SUCCESS(ingredientSkylineIsDominated(skyline, catalog[i],
+														&isDominated));
+			ASSERT_EQUALS(isDominated,
+				bruteForceDominated(catalog, live, CATALOG_SIZE, catalog[i]));
+		}
+		for (int i = 0; i < 100; i++) {
+			Ingredient query = randomIngredient();
+			ingredientSkylineIsDominated(skyline, query, &isDominated);
+			ASSERT_EQUALS(isDominated,
+				bruteForceDominated(catalog, live, CATALOG_SIZE, query));
+		}
+		for (int i = round % 2; i < CATALOG_SIZE; i += 2) {
+			int id;
+			if (live[i]) {
+				ASSERT_SUCCESS(ingredientSkylineRemove(skyline, i));
+				live[i] = false;
+			} else {
+				Ingredient ingredient = randomIngredient();
+				ASSERT_SUCCESS(ingredientSkylineInsert(skyline, ingredient, &id));
+				ASSERT(id >= 0 && id < CATALOG_SIZE && !live[id]);
+				catalog[id] = ingredient;
+				live[id] = true;
+			}
+		}
+	}
+
+	ingredientSkylineDestroy(skyline);
+	return true;
+}
+
+static bool testGetFrontier() {
+	Ingredient catalog[CATALOG_SIZE];
+	bool live[CATALOG_SIZE];
+	IngredientSkyline skyline = ingredientSkylineCreate();
+	for (int i = 0; i < CATALOG_SIZE; i++) {
+		catalog[i] = randomIngredient();
+		live[i] = true;
+		ingredientSkylineInsert(skyline, catalog[i], NULL);
+	}
+	int ids[CATALOG_SIZE];
+	int count;
+
+	ASSERT_NULL_ARGUMENT(ingredientSkylineGetFrontier(skyline, NULL, &count));
+	ASSERT_SUCCESS(ingredientSkylineGetFrontier(skyline, ids, &count));
+	int expected = 0;
+	for (int i = 0; i < CATALOG_SIZE; i++) {
+		if (!bruteForceDominated(catalog, live, CATALOG_SIZE, catalog[i])) {
+			ASSERT(expected < count && ids[expected] == i);
+			expected++;
+		}
+	}
+	ASSERT_EQUALS(count, expected);
+
+	ingredientSkylineDestroy(skyline);
+	return true;
+}
+
+static bool testFindSubstitute() {
+	Ingredient catalog[CATALOG_SIZE];
+	for (int i = 0; i < CATALOG_SIZE; i++) {
+		catalog[i] = randomIngredient();
+	}
+	IngredientSkyline skyline = ingredientSkylineCreateFrom(catalog,
+															CATALOG_SIZE);
+	bool allowed[INGREDIENT_KOSHER_TYPE_VALUES] = { true, false, true };
+	Ingredient queries[100];
+	int ids[100];
+	int id;
+
+	ASSERT_NULL_ARGUMENT(ingredientSkylineFindSubstitute(skyline, catalog[0],
+															NULL, NULL));
+	for (int i = 0; i < 100; i++) {
+		queries[i] = randomIngredient();
+	}
+	ASSERT_SUCCESS(ingredientSkylineFindSubstitutes(skyline, queries, 100,
+													allowed, ids));
+	for (int i = 0; i < 100; i++) {
+		int expected = INGREDIENT_SKYLINE_NO_ID;
+		for (int j = 0; j < CATALOG_SIZE; j++) {
+			if (allowed[catalog[j].kosherType] &&
+					ingredientIsBetter(catalog[j], queries[i]) &&
+					(expected == INGREDIENT_SKYLINE_NO_ID ||
+					ingredientIsCheaper(catalog[j], catalog[expected]))) {
+				expected = j;
+			}
+		}
+		IngredientSkylineResult result = ingredientSkylineFindSubstitute(
+									skyline, queries[i], allowed, &id);
+		ASSERT_EQUALS(id, ids[i]);
+		if (expected == INGREDIENT_SKYLINE_NO_ID) {
+			ASSERT_EQUALS(result, INGREDIENT_SKYLINE_NOT_FOUND);
+			ASSERT_EQUALS(id, INGREDIENT_SKYLINE_NO_ID);
+		} else {
+			ASSERT_SUCCESS(result);
+			ASSERT(allowed[catalog[id].kosherType]);
+			ASSERT_TRUE(ingredientIsBetter(catalog[id], queries[i]));
+			ASSERT_EQUALS(catalog[id].cost, catalog[expected].cost);
+		}
+	}
+
+	ingredientSkylineDestroy(skyline);
+	return true;
+}
+
+int main() {
+
+	RUN_TEST(testInsertAndRemove);
+	RUN_TEST(testMatchesIsBetter);
+	RUN_TEST(testGetFrontier);
+	RUN_TEST(testFindSubstitute);
+
+	return 0;
+}
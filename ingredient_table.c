@@ -0,0 +1,469 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <float.h>
+#include "ingredient_table.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return INGREDIENT_TABLE_NULL_ARGUMENT;	}
+
+#define INGREDIENT_TABLE_MIN_CAPACITY 16
+
+#define CALORIE_RANGE (INGREDIENT_MAX_CALORIES-INGREDIENT_MIN_CALORIES)
+#define HEALTH_RANGE (INGREDIENT_MAX_HEALTH-INGREDIENT_MIN_HEALTH)
+
+/*
+ * Fixed-point costs are discounted in micro-units, which the discount kernels
+ * don't do, so they leave every row to the scalar loop.
+ */
+#ifdef INGREDIENT_FIXED_POINT_COSTS
+#define VECTOR_DISCOUNTS false
+#else
+#define VECTOR_DISCOUNTS true
+#endif
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+static IngredientTableResult growTable(IngredientTable table, int capacity) {
+	void* names = realloc(table->names, sizeof(*table->names)*capacity);
+	if (names == NULL) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	table->names = names;
+	KosherType* kosherTypes = (KosherType*)realloc(table->kosherTypes,
+												sizeof(KosherType)*capacity);
+	if (kosherTypes == NULL) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	table->kosherTypes = kosherTypes;
+	int* calories = (int*)realloc(table->calories, sizeof(int)*capacity);
+	if (calories == NULL) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	table->calories = calories;
+	int* health = (int*)realloc(table->health, sizeof(int)*capacity);
+	if (health == NULL) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	table->health = health;
+	double* costs = (double*)realloc(table->costs, sizeof(double)*capacity);
+	if (costs == NULL) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	table->costs = costs;
+	table->capacity = capacity;
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+static void qualityScalar(IngredientTable table, int first, double* qualities) {
+	for (int i=first;i<table->size;i++) {
+		qualities[i] = ingredientGetQualityOf(table->calories[i],
+												table->health[i]);
+	}
+}
+
+static void isCheaperScalar(IngredientTable table, int first, double cost,
+							bool* areCheaper) {
+	for (int i=first;i<table->size;i++) {
+		areCheaper[i] = (table->costs[i] < cost);
+	}
+}
+
+static void isBetterScalar(IngredientTable table, int first,
+							Ingredient ingredient, bool* areBetter) {
+	for (int i=first;i<table->size;i++) {
+		areBetter[i] = (table->costs[i] < ingredient.cost &&
+						table->calories[i] < ingredient.calories &&
+						table->health[i] > ingredient.health);
+	}
+}
+
+static void discountScalar(IngredientTable table, int first, int discount,
+						const int* discounts, IngredientResult* results) {
+	Ingredient ingredient;
+	for (int i=first;i<table->size;i++) {
+		results[i] = ingredientChangeCost(&ingredient,table->costs[i],
+								discounts == NULL ? discount : discounts[i]);
+		if (results[i] == INGREDIENT_SUCCESS) {
+			table->costs[i] = ingredient.cost;
+		}
+	}
+}
+
+/*
+ * The vector kernels process as many whole vectors as fit, and return the
+ * first row left for the scalar loop.
+ */
+#if defined(__AVX2__) || defined(__SSE2__)
+static void storeMask(int mask, int lanes, bool* results) {
+	for (int k=0;k<lanes;k++) {
+		results[k] = (mask >> k) & 1;
+	}
+}
+
+/* Gives each lane the code ingredientChangeCost would give it. */
+static void storeDiscountResults(int validCosts, int validDiscounts, int lanes,
+								IngredientResult* results) {
+	for (int k=0;k<lanes;k++) {
+		IngredientResult result = INGREDIENT_SUCCESS;
+		result = ((validDiscounts >> k) & 1) ? result : INGREDIENT_BAD_DISCOUNT;
+		result = ((validCosts >> k) & 1) ? result : INGREDIENT_BAD_COST;
+		results[k] = result;
+	}
+}
+#endif
+
+#if defined(__AVX2__)
+
+#define VECTOR_LANES 4
+
+/*
+ * Gathers each vector of qualities from ingredientQualityTable. A vector with
+ * a row out of the table's ranges is left to ingredientGetQualityOf.
+ */
+static int qualityVector(IngredientTable table, double* qualities) {
+	const __m128i minCalories = _mm_set1_epi32(INGREDIENT_MIN_CALORIES-1);
+	const __m128i maxCalories = _mm_set1_epi32(INGREDIENT_MAX_CALORIES+1);
+	const __m128i minHealth = _mm_set1_epi32(INGREDIENT_MIN_HEALTH-1);
+	const __m128i maxHealth = _mm_set1_epi32(INGREDIENT_MAX_HEALTH+1);
+	const __m128i healthValues = _mm_set1_epi32(INGREDIENT_HEALTH_VALUES);
+	const __m128i firstIndex = _mm_set1_epi32(
+		INGREDIENT_QUALITY_INDEX(INGREDIENT_MIN_CALORIES,INGREDIENT_MIN_HEALTH));
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m128i calories = _mm_loadu_si128((const __m128i*)(table->calories+i));
+		__m128i health = _mm_loadu_si128((const __m128i*)(table->health+i));
+		__m128i valid = _mm_and_si128(
+				_mm_and_si128(_mm_cmpgt_epi32(calories,minCalories),
+							_mm_cmplt_epi32(calories,maxCalories)),
+				_mm_and_si128(_mm_cmpgt_epi32(health,minHealth),
+							_mm_cmplt_epi32(health,maxHealth)));
+		if (_mm_movemask_ps(_mm_castsi128_ps(valid)) != 0xF) {
+			for (int k=i;k<i+VECTOR_LANES;k++) {
+				qualities[k] = ingredientGetQualityOf(table->calories[k],
+														table->health[k]);
+			}
+			continue;
+		}
+		__m128i index = _mm_sub_epi32(_mm_add_epi32(
+				_mm_mullo_epi32(calories,healthValues),health),firstIndex);
+		_mm256_storeu_pd(qualities+i,
+				_mm256_i32gather_pd(ingredientQualityTable,index,sizeof(double)));
+	}
+	return i;
+}
+
+static int isCheaperVector(IngredientTable table, double cost,
+							bool* areCheaper) {
+	const __m256d reference = _mm256_set1_pd(cost);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m256d costs = _mm256_loadu_pd(table->costs+i);
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(costs,reference,_CMP_LT_OQ));
+		storeMask(mask,VECTOR_LANES,areCheaper+i);
+	}
+	return i;
+}
+
+static int isBetterVector(IngredientTable table, Ingredient ingredient,
+							bool* areBetter) {
+	const __m256d cost = _mm256_set1_pd(ingredient.cost);
+	const __m128i calories = _mm_set1_epi32(ingredient.calories);
+	const __m128i health = _mm_set1_epi32(ingredient.health);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m256d costs = _mm256_loadu_pd(table->costs+i);
+		__m128i rowCalories = _mm_loadu_si128((const __m128i*)(table->calories+i));
+		__m128i rowHealth = _mm_loadu_si128((const __m128i*)(table->health+i));
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(costs,cost,_CMP_LT_OQ));
+		__m128i better = _mm_and_si128(_mm_cmplt_epi32(rowCalories,calories),
+										_mm_cmpgt_epi32(rowHealth,health));
+		mask &= _mm_movemask_ps(_mm_castsi128_ps(better));
+		storeMask(mask,VECTOR_LANES,areBetter+i);
+	}
+	return i;
+}
+
+/*
+ * A cost is valid if it is between 0 and DBL_MAX, which also rules out NaN
+ * and infinity. The new cost is computed as ingredientChangeCost computes it,
+ * and stored only in the lanes where both the cost and the discount are valid.
+ */
+static int discountVector(IngredientTable table, int discount,
+						const int* discounts, IngredientResult* results) {
+	const __m128i uniform = _mm_set1_epi32(discount);
+	const __m128i belowMin = _mm_set1_epi32(-1);
+	const __m128i aboveMax = _mm_set1_epi32(101);
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d maxCost = _mm256_set1_pd(DBL_MAX);
+	const __m256d one = _mm256_set1_pd(1);
+	const __m256d percent = _mm256_set1_pd(0.01);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m256d costs = _mm256_loadu_pd(table->costs+i);
+		__m128i rowDiscounts = discounts == NULL ? uniform :
+						_mm_loadu_si128((const __m128i*)(discounts+i));
+		__m256d validCosts = _mm256_and_pd(
+						_mm256_cmp_pd(costs,zero,_CMP_GE_OQ),
+						_mm256_cmp_pd(costs,maxCost,_CMP_LE_OQ));
+		__m128i validDiscounts = _mm_and_si128(
+						_mm_cmpgt_epi32(rowDiscounts,belowMin),
+						_mm_cmplt_epi32(rowDiscounts,aboveMax));
+		__m256d valid = _mm256_and_pd(validCosts,
+				_mm256_castsi256_pd(_mm256_cvtepi32_epi64(validDiscounts)));
+		__m256d factor = _mm256_sub_pd(one,
+				_mm256_mul_pd(_mm256_cvtepi32_pd(rowDiscounts),percent));
+		_mm256_storeu_pd(table->costs+i,_mm256_blendv_pd(costs,
+										_mm256_mul_pd(costs,factor),valid));
+		storeDiscountResults(_mm256_movemask_pd(validCosts),
+						_mm_movemask_ps(_mm_castsi128_ps(validDiscounts)),
+						VECTOR_LANES,results+i);
+	}
+	return i;
+}
+
+#elif defined(__SSE2__)
+
+#define VECTOR_LANES 2
+
+static __m128d loadInts(const int* values) {
+	return _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)values));
+}
+
+/*
+ * SSE2 has no gather, so the kernel evaluates the quality formula two rows at
+ * a time, in the same operations as ingredientGetQualityOf, which gives the
+ * same values as the table for every row. With an empty range every quality
+ * is an error code, which is left to the scalar loop.
+ */
+static int qualityVector(IngredientTable table, double* qualities) {
+#if CALORIE_RANGE == 0 || HEALTH_RANGE == 0
+	(void)table;
+	(void)qualities;
+	return 0;
+#else
+	const __m128d calorieFactor = _mm_set1_pd(10.0/CALORIE_RANGE);
+	const __m128d healthFactor = _mm_set1_pd(10.0/HEALTH_RANGE);
+	const __m128d zero = _mm_setzero_pd();
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m128d calories = loadInts(table->calories+i);
+		__m128d health = loadInts(table->health+i);
+		__m128d quality = _mm_sub_pd(_mm_mul_pd(health,healthFactor),
+									_mm_mul_pd(calories,calorieFactor));
+		_mm_storeu_pd(qualities+i,_mm_max_pd(quality,zero));
+	}
+	return i;
+#endif
+}
+
+static int isCheaperVector(IngredientTable table, double cost,
+							bool* areCheaper) {
+	const __m128d reference = _mm_set1_pd(cost);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m128d costs = _mm_loadu_pd(table->costs+i);
+		int mask = _mm_movemask_pd(_mm_cmplt_pd(costs,reference));
+		storeMask(mask,VECTOR_LANES,areCheaper+i);
+	}
+	return i;
+}
+
+static int isBetterVector(IngredientTable table, Ingredient ingredient,
+							bool* areBetter) {
+	const __m128d cost = _mm_set1_pd(ingredient.cost);
+	const __m128d calories = _mm_set1_pd(ingredient.calories);
+	const __m128d health = _mm_set1_pd(ingredient.health);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m128d better = _mm_and_pd(
+				_mm_cmplt_pd(_mm_loadu_pd(table->costs+i),cost),
+				_mm_cmplt_pd(loadInts(table->calories+i),calories));
+		better = _mm_and_pd(better,
+				_mm_cmpgt_pd(loadInts(table->health+i),health));
+		storeMask(_mm_movemask_pd(better),VECTOR_LANES,areBetter+i);
+	}
+	return i;
+}
+
+/* Same as the AVX2 kernel, with an and/andnot select instead of a blend. */
+static int discountVector(IngredientTable table, int discount,
+						const int* discounts, IngredientResult* results) {
+	const __m128i uniform = _mm_set1_epi32(discount);
+	const __m128i belowMin = _mm_set1_epi32(-1);
+	const __m128i aboveMax = _mm_set1_epi32(101);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d maxCost = _mm_set1_pd(DBL_MAX);
+	const __m128d one = _mm_set1_pd(1);
+	const __m128d percent = _mm_set1_pd(0.01);
+	int i = 0;
+	for (;i+VECTOR_LANES<=table->size;i+=VECTOR_LANES) {
+		__m128d costs = _mm_loadu_pd(table->costs+i);
+		__m128i rowDiscounts = discounts == NULL ? uniform :
+						_mm_loadl_epi64((const __m128i*)(discounts+i));
+		__m128d validCosts = _mm_and_pd(_mm_cmpge_pd(costs,zero),
+										_mm_cmple_pd(costs,maxCost));
+		__m128i validDiscounts = _mm_and_si128(
+						_mm_cmpgt_epi32(rowDiscounts,belowMin),
+						_mm_cmplt_epi32(rowDiscounts,aboveMax));
+		__m128d valid = _mm_and_pd(validCosts, _mm_castsi128_pd(
+					_mm_unpacklo_epi32(validDiscounts,validDiscounts)));
+		__m128d discounted = _mm_mul_pd(costs,_mm_sub_pd(one,
+					_mm_mul_pd(_mm_cvtepi32_pd(rowDiscounts),percent)));
+		_mm_storeu_pd(table->costs+i,_mm_or_pd(_mm_and_pd(valid,discounted),
+											_mm_andnot_pd(valid,costs)));
+		storeDiscountResults(_mm_movemask_pd(validCosts),
+						_mm_movemask_ps(_mm_castsi128_ps(validDiscounts)),
+						VECTOR_LANES,results+i);
+	}
+	return i;
+}
+
+#else
+
+static int qualityVector(IngredientTable table, double* qualities) {
+	(void)table;
+	(void)qualities;
+	return 0;
+}
+
+static int isCheaperVector(IngredientTable table, double cost,
+							bool* areCheaper) {
+	(void)table;
+	(void)cost;
+	(void)areCheaper;
+	return 0;
+}
+
+static int isBetterVector(IngredientTable table, Ingredient ingredient,
+							bool* areBetter) {
+	(void)table;
+	(void)ingredient;
+	(void)areBetter;
+	return 0;
+}
+
+static int discountVector(IngredientTable table, int discount,
+						const int* discounts, IngredientResult* results) {
+	(void)table;
+	(void)discount;
+	(void)discounts;
+	(void)results;
+	return 0;
+}
+
+#endif
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+IngredientTable ingredientTableCreate(int capacity) {
+	if (capacity < INGREDIENT_TABLE_MIN_CAPACITY) {
+		capacity = INGREDIENT_TABLE_MIN_CAPACITY;
+	}
+	IngredientTable table = (IngredientTable)malloc(sizeof(*table));
+	if (table == NULL) {
+		return NULL;
+	}
+	table->size = 0;
+	table->capacity = 0;
+	table->names = NULL;
+	table->kosherTypes = NULL;
+	table->calories = NULL;
+	table->health = NULL;
+	table->costs = NULL;
+	if (growTable(table,capacity) != INGREDIENT_TABLE_SUCCESS) {
+		ingredientTableDestroy(table);
+		return NULL;
+	}
+	return table;
+}
+
+void ingredientTableDestroy(IngredientTable table) {
+	if (table == NULL) {
+		return;
+	}
+	free(table->names);
+	free(table->kosherTypes);
+	free(table->calories);
+	free(table->health);
+	free(table->costs);
+	free(table);
+}
+
+IngredientTableResult ingredientTableAdd(IngredientTable table,
+										Ingredient ingredient) {
+	CHECK_NULL_ARG(table)
+	if (table->size == table->capacity &&
+			growTable(table,table->capacity*2) != INGREDIENT_TABLE_SUCCESS) {
+		return INGREDIENT_TABLE_OUT_OF_MEMORY;
+	}
+	int row = table->size;
+	memcpy(&table->names[row],&ingredient.name,sizeof(IngredientName));
+	table->kosherTypes[row] = ingredient.kosherType;
+	table->calories[row] = ingredient.calories;
+	table->health[row] = ingredient.health;
+	table->costs[row] = ingredient.cost;
+	table->size++;
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+IngredientTableResult ingredientTableGet(IngredientTable table, int index,
+										Ingredient* ingredient) {
+	CHECK_NULL_ARG(table)
+	CHECK_NULL_ARG(ingredient)
+	if (index < 0 || index >= table->size) {
+		return INGREDIENT_TABLE_OUT_OF_RANGE;
+	}
+	memcpy(&ingredient->name,&table->names[index],sizeof(IngredientName));
+	ingredient->kosherType = table->kosherTypes[index];
+	ingredient->calories = table->calories[index];
+	ingredient->health = table->health[index];
+	ingredient->cost = table->costs[index];
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+IngredientTableResult ingredientTableGetQuality(IngredientTable table,
+												double* qualities) {
+	CHECK_NULL_ARG(table)
+	CHECK_NULL_ARG(qualities)
+	qualityScalar(table,qualityVector(table,qualities),qualities);
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+IngredientTableResult ingredientTableIsCheaper(IngredientTable table,
+									Ingredient ingredient, bool* areCheaper) {
+	CHECK_NULL_ARG(table)
+	CHECK_NULL_ARG(areCheaper)
+	isCheaperScalar(table,isCheaperVector(table,ingredient.cost,areCheaper),
+					ingredient.cost,areCheaper);
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+IngredientTableResult ingredientTableIsBetter(IngredientTable table,
+									Ingredient ingredient, bool* areBetter) {
+	CHECK_NULL_ARG(table)
+	CHECK_NULL_ARG(areBetter)
+	isBetterScalar(table,isBetterVector(table,ingredient,areBetter),
+					ingredient,areBetter);
+	return INGREDIENT_TABLE_SUCCESS;
+}
+
+IngredientTableResult ingredientTableApplyDiscount(IngredientTable table,
+		int discount, const int* discounts, IngredientResult* results) {
+	CHECK_NULL_ARG(table)
+	CHECK_NULL_ARG(results)
+	int first = 0;
+	if (VECTOR_DISCOUNTS) {
+		first = discountVector(table,discount,discounts,results);
+	}
+	discountScalar(table,first,discount,discounts,results);
+	return INGREDIENT_TABLE_SUCCESS;
+}
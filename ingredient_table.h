@@ -0,0 +1,138 @@
+/*
+ * ingredient_table.h
+ *
+ * A columnar (structure of arrays) table of ingredients. Each field of
+ * Ingredient is kept in its own array, so scans over the numeric fields
+ * don't pull names through the cache, and can be vectorized.
+ */
+
+#ifndef INGREDIENT_TABLE_H_
+#define INGREDIENT_TABLE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Ingredient Table Struct
+ *
+ * Row i of the table is the ingredient made of names[i], kosherTypes[i],
+ * calories[i], health[i] and costs[i]. All columns have room for capacity
+ * rows, of which the first size are in use.
+ ******************************************************************************/
+typedef struct ingredient_table_t {
+	int size;
+	int capacity;
+	IngredientName* names;
+	KosherType* kosherTypes;
+	int* calories;
+	int* health;
+	double* costs;
+}* IngredientTable;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	INGREDIENT_TABLE_SUCCESS,			/* Operation succeeded 				  */
+	INGREDIENT_TABLE_NULL_ARGUMENT,		/* A NULL argument was passed 		  */
+	INGREDIENT_TABLE_OUT_OF_RANGE,		/* The passed row index is negative or
+										   out of bounds					  */
+	INGREDIENT_TABLE_OUT_OF_MEMORY		/* A memory error occured			  */
+} IngredientTableResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a new empty table with room for @capacity rows.
+ * The table grows as needed when more rows are added.
+ *
+ * @param capacity The number of rows to allocate up front.
+ * @return The new table, or NULL if any error occured.
+ */
+IngredientTable ingredientTableCreate(int capacity);
+
+/*
+ * Destroy a given table, deallocating all necessary memory.
+ *
+ * @param table The table to destroy.
+ */
+void ingredientTableDestroy(IngredientTable table);
+
+/*
+ * Append an ingredient to the end of the table.
+ * The ingredient is copied as is, it should be a valid ingredient.
+ *
+ * @param table The table to add to.
+ * @param ingredient The ingredient to add.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableAdd(IngredientTable table,
+										Ingredient ingredient);
+
+/*
+ * Place the ingredient stored in a given row in @ingredient.
+ *
+ * @param table The table to read from.
+ * @param index The row to read.
+ * @param ingredient The ingredient will be placed here.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableGet(IngredientTable table, int index,
+										Ingredient* ingredient);
+
+/*
+ * Compute the quality of every row, as ingredientGetQuality would.
+ * qualities[i] will hold the quality of row i.
+ *
+ * @param table The table to evaluate.
+ * @param qualities An array with room for the table's size.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableGetQuality(IngredientTable table,
+												double* qualities);
+
+/*
+ * Compare every row with a given ingredient, as ingredientIsCheaper would.
+ * areCheaper[i] will hold whether row i is cheaper than @ingredient.
+ *
+ * @param table The table to evaluate.
+ * @param ingredient The ingredient to compare with.
+ * @param areCheaper An array with room for the table's size.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableIsCheaper(IngredientTable table,
+									Ingredient ingredient, bool* areCheaper);
+
+/*
+ * Compare every row with a given ingredient, as ingredientIsBetter would.
+ * areBetter[i] will hold whether row i is better than @ingredient.
+ *
+ * @param table The table to evaluate.
+ * @param ingredient The ingredient to compare with.
+ * @param areBetter An array with room for the table's size.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableIsBetter(IngredientTable table,
+									Ingredient ingredient, bool* areBetter);
+
+/*
+ * Apply a discount to the cost of every row, as ingredientApplyDiscountBatch
+ * would. If @discounts is NULL every row gets @discount, otherwise row i gets
+ * discounts[i]. results[i] will hold row i's success or error code, and rows
+ * with an error keep their cost.
+ *
+ * @param table The table to update.
+ * @param discount The discount in percentage for every row.
+ * @param discounts The discount in percentage of each row, or NULL.
+ * @param results An array with room for the table's size.
+ * @return Success or error code.
+ */
+IngredientTableResult ingredientTableApplyDiscount(IngredientTable table,
+		int discount, const int* discounts, IngredientResult* results);
+
+#endif /* INGREDIENT_TABLE_H_ */
@@ -0,0 +1,178 @@
+#include "ingredient_table.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+#define ASSERT_DOUBLE_EQUALS(expr,expected) ASSERT(DOUBLE_EQUALS(expr, expected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, INGREDIENT_TABLE_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) ASSERT_EQUALS(expr, INGREDIENT_TABLE_NULL_ARGUMENT)
+
+#define TABLE_ROWS 103
+
+static Ingredient makeRow(int i) {
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+	sprintf(name, "Row %d", i);
+	return ingredientInitialize(name, i % INGREDIENT_KOSHER_TYPE_VALUES,
+			(i * 37) % (INGREDIENT_MAX_CALORIES + 1),
+			(i * 7) % (INGREDIENT_MAX_HEALTH + 1), (i * 13) % 50 + 0.5, NULL);
+}
+
+static IngredientTable makeTable() {
+	IngredientTable table = ingredientTableCreate(0);
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ingredientTableAdd(table, makeRow(i));
+	}
+	return table;
+}
+
+static bool testAddAndGet() {
+	IngredientTable table = ingredientTableCreate(1);
+	ASSERT_NOT_EQUALS(table, NULL);
+	Ingredient ing = ingredientInitialize("Tomato", MILKY, 30, 4, 2.5, NULL);
+	Ingredient result;
+
+	ASSERT_NULL_ARGUMENT(ingredientTableAdd(NULL, ing));
+	ASSERT_NULL_ARGUMENT(ingredientTableGet(table, 0, NULL));
+	ASSERT_EQUALS(ingredientTableGet(table, 0, &result),
+					INGREDIENT_TABLE_OUT_OF_RANGE);
+
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ASSERT_SUCCESS(ingredientTableAdd(table, makeRow(i)));
+	}
+	ASSERT_SUCCESS(ingredientTableAdd(table, ing));
+	ASSERT_EQUALS(table->size, TABLE_ROWS + 1);
+	ASSERT_SUCCESS(ingredientTableGet(table, TABLE_ROWS, &result));
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&result), "Tomato"), 0);
+	ASSERT_EQUALS(result.kosherType, MILKY);
+	ASSERT_EQUALS(result.calories, 30);
+	ASSERT_EQUALS(result.health, 4);
+	ASSERT_DOUBLE_EQUALS(result.cost, 2.5);
+	ASSERT_EQUALS(ingredientTableGet(table, -1, &result),
+					INGREDIENT_TABLE_OUT_OF_RANGE);
+
+	ingredientTableDestroy(table);
+	return true;
+}
+
+static bool testGetQuality() {
+	IngredientTable table = makeTable();
+	double qualities[TABLE_ROWS];
+
+	ASSERT_NULL_ARGUMENT(ingredientTableGetQuality(table, NULL));
+	ASSERT_SUCCESS(ingredientTableGetQuality(table, qualities));
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ASSERT_EQUALS(qualities[i], ingredientGetQuality(makeRow(i)));
+	}
+
+	/* rows out of the quality table's ranges still get the formula's value */
+	table->calories[5] = INGREDIENT_MAX_CALORIES + 100;
+	table->health[6] = INGREDIENT_MAX_HEALTH + 1;
+	ASSERT_SUCCESS(ingredientTableGetQuality(table, qualities));
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ASSERT_EQUALS(qualities[i], ingredientGetQualityOf(table->calories[i],
+														table->health[i]));
+	}
+
+	ingredientTableDestroy(table);
+	return true;
+}
+
+static bool testIsCheaper() {
+	IngredientTable table = makeTable();
+	bool areCheaper[TABLE_ROWS];
+
+	for (int j = 0; j < TABLE_ROWS; j += 10) {
+		ASSERT_SUCCESS(ingredientTableIsCheaper(table, makeRow(j), areCheaper));
+		for (int i = 0; i < TABLE_ROWS; i++) {
+			ASSERT_EQUALS(areCheaper[i],
+							ingredientIsCheaper(makeRow(i), makeRow(j)));
+		}
+	}
+
+	ingredientTableDestroy(table);
+	return true;
+}
+
+static bool testIsBetter() {
+	IngredientTable table = makeTable();
+	bool areBetter[TABLE_ROWS];
+
+	ASSERT_NULL_ARGUMENT(ingredientTableIsBetter(NULL, makeRow(0), areBetter));
+	for (int j = 0; j < TABLE_ROWS; j += 10) {
+		ASSERT_SUCCESS(ingredientTableIsBetter(table, makeRow(j), areBetter));
+		for (int i = 0; i < TABLE_ROWS; i++) {
+			ASSERT_EQUALS(areBetter[i],
+							ingredientIsBetter(makeRow(i), makeRow(j)));
+		}
+	}
+
+	ingredientTableDestroy(table);
+	return true;
+}
+
+static bool testApplyDiscount() {
+	IngredientTable table = makeTable();
+	Ingredient ings[TABLE_ROWS];
+	IngredientResult results[TABLE_ROWS];
+	IngredientResult expected[TABLE_ROWS];
+	int discounts[TABLE_ROWS];
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ings[i] = makeRow(i);
+		discounts[i] = (i * 11) % 103 - 1;
+	}
+	table->costs[5] = ings[5].cost = -1;
+	table->costs[6] = ings[6].cost = NAN;
+	table->costs[7] = ings[7].cost = INFINITY;
+
+	ASSERT_NULL_ARGUMENT(ingredientTableApplyDiscount(NULL, 10, NULL, results));
+	ASSERT_NULL_ARGUMENT(ingredientTableApplyDiscount(table, 10, NULL, NULL));
+
+	ASSERT_SUCCESS(ingredientTableApplyDiscount(table, 15, NULL, results));
+	ingredientApplyDiscountBatch(ings, TABLE_ROWS, 15, NULL, expected);
+	ASSERT_SUCCESS(ingredientTableApplyDiscount(table, 0, discounts, results));
+	ingredientApplyDiscountBatch(ings, TABLE_ROWS, 0, discounts, expected);
+	for (int i = 0; i < TABLE_ROWS; i++) {
+		ASSERT_EQUALS(results[i], expected[i]);
+		ASSERT(table->costs[i] == ings[i].cost || isnan(ings[i].cost));
+	}
+	ASSERT_EQUALS(results[0], INGREDIENT_BAD_DISCOUNT);
+	ASSERT_EQUALS(results[5], INGREDIENT_BAD_COST);
+	ASSERT_EQUALS(results[6], INGREDIENT_BAD_COST);
+
+	ASSERT_SUCCESS(ingredientTableApplyDiscount(table, -5, NULL, results));
+	ASSERT_EQUALS(results[1], INGREDIENT_BAD_DISCOUNT);
+	ASSERT_EQUALS(results[5], INGREDIENT_BAD_COST);
+
+	ingredientTableDestroy(table);
+	return true;
+}
+
+int main() {
+
+	RUN_TEST(testAddAndGet);
+	RUN_TEST(testGetQuality);
+	RUN_TEST(testIsCheaper);
+	RUN_TEST(testIsBetter);
+	RUN_TEST(testApplyDiscount);
+
+	return 0;
+}
@@ -36,6 +36,7 @@
 #define ASSERT_BAD_CALORIES(expr) ASSERT_EQUALS(expr, INGREDIENT_BAD_CALORIES)
 #define ASSERT_BAD_HEALTH(expr) ASSERT_EQUALS(expr, INGREDIENT_BAD_HEALTH)
 #define ASSERT_BAD_COST(expr) ASSERT_EQUALS(expr, INGREDIENT_BAD_COST)
+#define ASSERT_BAD_DISCOUNT(expr) ASSERT_EQUALS(expr, INGREDIENT_BAD_DISCOUNT)
 
 static bool testInitialize() {
 
@@ -59,6 +60,135 @@ static bool testInitialize() {
 	return true;
 }
 
+static bool testValidate() {
+	Ingredient ing = ingredientInitialize("Tomato", PARVE, 10, 10, 10, NULL);
+	ASSERT_SUCCESS(ingredientValidate(ing));
+
+	Ingredient bad = ing;
+	bad.calories = INGREDIENT_MAX_CALORIES + 1;
+	ASSERT_BAD_CALORIES(ingredientValidate(bad));
+	bad = ing;
+	bad.health = INGREDIENT_MIN_HEALTH - 1;
+	ASSERT_BAD_HEALTH(ingredientValidate(bad));
+	bad = ing;
+	bad.cost = -1;
+	ASSERT_BAD_COST(ingredientValidate(bad));
+	bad = ing;
+	bad.kosherType = (KosherType)INGREDIENT_KOSHER_TYPE_VALUES;
+	ASSERT_EQUALS(ingredientValidate(bad), INGREDIENT_BAD_KOSHER_TYPE);
+
+	bad = ing;
+#ifdef INGREDIENT_INTERNED_NAMES
+	bad.name.id = namePoolSize() + 1;
+#else
+	memset(bad.name, 'x', sizeof(bad.name));
+#endif
+	ASSERT_EQUALS(ingredientValidate(bad), INGREDIENT_BAD_NAME);
+
+	return true;
+}
+
+static bool testValidIngredient() {
+	ValidIngredient valid;
+	ASSERT_NULL_ARGUMENT(ingredientInitializeValid("Tomato", PARVE, 10, 10, 10,
+												NULL));
+	ASSERT_SUCCESS(ingredientInitializeValid("Tomato", PARVE, 10, 10, 10,
+											&valid));
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&valid.ingredient), "Tomato"), 0);
+	ASSERT_EQUALS(valid.ingredient.calories, 10);
+
+	/* a failed call leaves the valid ingredient as it was */
+	ASSERT_BAD_HEALTH(ingredientInitializeValid("Onion", PARVE, 10,
+							INGREDIENT_MAX_HEALTH + 1, 10, &valid));
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&valid.ingredient), "Tomato"), 0);
+
+	Ingredient ing = ingredientInitialize("Onion", MEATY, 20, 5, 3, NULL);
+	ASSERT_NULL_ARGUMENT(ingredientToValid(ing, NULL));
+	ASSERT_SUCCESS(ingredientToValid(ing, &valid));
+	ASSERT_EQUALS(strcmp(ingredientPeekName(&valid.ingredient), "Onion"), 0);
+	ASSERT_EQUALS(valid.ingredient.kosherType, MEATY);
+	ing.cost = -1;
+	ASSERT_BAD_COST(ingredientToValid(ing, &valid));
+	ASSERT_DOUBLE_EQUALS(valid.ingredient.cost, 3);
+
+	return true;
+}
+
+static bool testInitializeBatch() {
+	enum { ROWS = 9 };
+	const char* names[ROWS] = { "Tomato", NULL, "", "Potato", "Onion",
+		"Garlic", "Leek", "Pepper",
+		"A name that is much too long for an ingredient" };
+	KosherType kosherTypes[ROWS] = { PARVE, MEATY, MILKY, (KosherType)7,
+		MEATY, MILKY, PARVE, MEATY, PARVE };
+	int calories[ROWS] = { 30, 10, 10, 10, -1, 10, 10, 2000, 10 };
+	int health[ROWS] = { 10, 2, 2, 2, 2, 11, 2, 0, 2 };
+	double costs[ROWS] = { 1.5, 1, 1, 1, 1, 1, -3, 9.25, 1 };
+	Ingredient ingredients[ROWS];
+	IngredientResult results[ROWS];
+
+	ASSERT_NULL_ARGUMENT(ingredientInitializeBatch(NULL, kosherTypes,
+		calories, health, costs, ROWS, ingredients, results));
+	ASSERT_NULL_ARGUMENT(ingredientInitializeBatch(names, kosherTypes,
+		calories, health, costs, ROWS, ingredients, NULL));
+
+	ASSERT_SUCCESS(ingredientInitializeBatch(names, kosherTypes, calories,
+		health, costs, ROWS, ingredients, results));
+	for (int i=0;i<ROWS;i++) {
+		IngredientResult expected;
+		Ingredient single = ingredientInitialize(names[i], kosherTypes[i],
+			calories[i], health[i], costs[i], &expected);
+		ASSERT_EQUALS(results[i], expected);
+		if (expected != INGREDIENT_SUCCESS) {
+			continue;
+		}
+		ASSERT_EQUALS(0, strcmp(ingredientPeekName(&ingredients[i]), names[i]));
+		ASSERT_EQUALS(ingredients[i].kosherType, single.kosherType);
+		ASSERT_EQUALS(ingredients[i].calories, single.calories);
+		ASSERT_EQUALS(ingredients[i].health, single.health);
+		ASSERT_EQUALS(ingredients[i].cost, single.cost);
+	}
+	ASSERT_SUCCESS(results[0]);
+	ASSERT_SUCCESS(results[7]);
+
+	return true;
+}
+
+static bool testInitializeBatchParallel() {
+	enum { ROWS = 3*4096+7 };
+	static const char* names[ROWS];
+	static KosherType kosherTypes[ROWS];
+	static int calories[ROWS];
+	static int health[ROWS];
+	static double costs[ROWS];
+	static Ingredient ingredients[ROWS];
+	static IngredientResult results[ROWS];
+	const char* pool[] = { "Tomato", NULL, "Potato", "", "Onion" };
+	for (int i=0;i<ROWS;i++) {
+		names[i] = pool[i % 5];
+		kosherTypes[i] = (KosherType)(i % INGREDIENT_KOSHER_TYPE_VALUES);
+		calories[i] = i % 2003;
+		health[i] = i % 12;
+		costs[i] = (i % 7) - 1;
+	}
+
+	ASSERT_NULL_ARGUMENT(ingredientInitializeBatchParallel(names, NULL,
+		calories, health, costs, ROWS, 4, ingredients, results));
+	ASSERT_SUCCESS(ingredientInitializeBatchParallel(names, kosherTypes,
+		calories, health, costs, ROWS, 4, ingredients, results));
+	for (int i=0;i<ROWS;i++) {
+		IngredientResult expected;
+		Ingredient single = ingredientInitialize(names[i], kosherTypes[i],
+			calories[i], health[i], costs[i], &expected);
+		ASSERT_EQUALS(results[i], expected);
+		if (expected == INGREDIENT_SUCCESS) {
+			ASSERT_EQUALS(ingredients[i].calories, single.calories);
+			ASSERT_EQUALS(ingredients[i].cost, single.cost);
+		}
+	}
+	return true;
+}
+
 static bool testGetName() {
 	Ingredient ing = ingredientInitialize("Tomato", MEATY, 10, 10, 10, NULL);
 
@@ -68,6 +198,14 @@ static bool testGetName() {
 
 	ASSERT_NULL_ARGUMENT(ingredientGetName(ing, NULL, 10000));
 
+	ASSERT_EQUALS(0, strcmp(ingredientPeekName(&ing), "Tomato"));
+	ASSERT_EQUALS(ingredientPeekName(NULL), NULL);
+
+	Ingredient same = ingredientInitialize("Tomato", PARVE, 20, 1, 1, NULL);
+	Ingredient other = ingredientInitialize("Tomatoes", MEATY, 10, 10, 10, NULL);
+	ASSERT_TRUE(ingredientHaveSameName(ing, same));
+	ASSERT_FALSE(ingredientHaveSameName(ing, other));
+
 	return true;
 }
 
@@ -80,6 +218,58 @@ static bool testChangeCost() {
 	ASSERT_SUCCESS(ingredientChangeCost(&ing, 100, 40));
 	ASSERT_DOUBLE_EQUALS(ing.cost, 60);
 
+	ASSERT_SUCCESS(ingredientChangeCost(&ing, 0.3, 10));
+	ASSERT_EQUALS(ingredientGetCostMicros(ing), 270000);
+
+	return true;
+}
+
+static bool testApplyDiscountBatch() {
+	Ingredient ings[4];
+	IngredientResult results[4];
+	int discounts[] = { 50, 0, 101, 10 };
+	for (int i=0;i<4;i++) {
+		ings[i] = ingredientInitialize("Tomato", PARVE, 10, 10, 100, NULL);
+	}
+	ings[3].cost = -1;
+
+	ASSERT_NULL_ARGUMENT(ingredientApplyDiscountBatch(NULL, 4, 10, NULL,
+													results));
+	ASSERT_NULL_ARGUMENT(ingredientApplyDiscountBatch(ings, 4, 10, NULL, NULL));
+	ASSERT_SUCCESS(ingredientApplyDiscountBatch(NULL, 0, 10, NULL, NULL));
+
+	ASSERT_SUCCESS(ingredientApplyDiscountBatch(ings, 4, 20, NULL, results));
+	for (int i=0;i<3;i++) {
+		ASSERT_SUCCESS(results[i]);
+		ASSERT_DOUBLE_EQUALS(ings[i].cost, 80);
+	}
+	ASSERT_BAD_COST(results[3]);
+	ASSERT_EQUALS(ings[3].cost, -1);
+
+	ASSERT_SUCCESS(ingredientApplyDiscountBatch(ings, 4, 20, discounts,
+												results));
+	ASSERT_SUCCESS(results[0]);
+	ASSERT_DOUBLE_EQUALS(ings[0].cost, 40);
+	ASSERT_SUCCESS(results[1]);
+	ASSERT_DOUBLE_EQUALS(ings[1].cost, 80);
+	ASSERT_BAD_DISCOUNT(results[2]);
+	ASSERT_DOUBLE_EQUALS(ings[2].cost, 80);
+	ASSERT_BAD_COST(results[3]);
+
+	return true;
+}
+
+static bool testCostMicros() {
+	Ingredient ing = ingredientInitialize("Tomato", PARVE, 10, 10, 1.25, NULL);
+	ASSERT_EQUALS(ingredientGetCostMicros(ing), 1250000);
+	ASSERT_EQUALS(ingredientCostFromMicros(1500000), 1.5);
+	ASSERT_EQUALS(ingredientCostFromMicros(0), 0);
+
+	ing = ingredientInitialize("Tomato", PARVE, 10, 10, 0.1, NULL);
+	ASSERT_EQUALS(ingredientGetCostMicros(ing), 100000);
+	ASSERT_EQUALS(ingredientCostFromMicros(ingredientGetCostMicros(ing)),
+				ing.cost);
+
 	return true;
 }
 
@@ -87,6 +277,19 @@ static bool testGetQuality() {
 	Ingredient ing = ingredientInitialize("A", MEATY, 400, 6, 1, NULL);
 	ASSERT_EQUALS(ingredientGetQuality(ing), 4);
 
+	for (int calories = INGREDIENT_MIN_CALORIES;
+			calories <= INGREDIENT_MAX_CALORIES; calories += 7) {
+		for (int health = INGREDIENT_MIN_HEALTH;
+				health <= INGREDIENT_MAX_HEALTH; health++) {
+			ing.calories = calories;
+			ing.health = health;
+			double expected = health*(10.0/INGREDIENT_MAX_HEALTH) -
+								calories*(10.0/INGREDIENT_MAX_CALORIES);
+			ASSERT_EQUALS(ingredientGetQuality(ing),
+							expected > 0 ? expected : 0);
+		}
+	}
+
 	return true;
 }
 
@@ -131,8 +334,14 @@ static bool testAreKosher() {
 int main() {
 
 	RUN_TEST(testInitialize);
+	RUN_TEST(testValidate);
+	RUN_TEST(testValidIngredient);
+	RUN_TEST(testInitializeBatch);
+	RUN_TEST(testInitializeBatchParallel);
 	RUN_TEST(testGetName);
 	RUN_TEST(testChangeCost);
+	RUN_TEST(testApplyDiscountBatch);
+	RUN_TEST(testCostMicros);
 	RUN_TEST(testGetQuality);
 	RUN_TEST(testIsCheaper);
 	RUN_TEST(testIsBetter);
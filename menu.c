@@ -0,0 +1,491 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "menu.h"
+
+#undef CHECK_NULL_ARG
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return MENU_NULL_ARGUMENT;	}
+
+#define MENU_MIN_CAPACITY 16
+#define MENU_MAX_CAPACITY (1 << 29)
+#define NO_DISH (-1)
+
+/*
+ * An index maps a key, the dish name or the cook, to the chain of positions
+ * in dishes of the dishes with that key. The slots are an open addressing
+ * hash table with linear probing, holding each key's hash and the first
+ * position of its chain. A slot whose head is NO_DISH is empty. Removal
+ * shifts the following slots of the probe run back, as the name set does.
+ * next and prev link the positions of a chain, and hashes holds the hash of
+ * each position's key.
+ *
+ * There are twice as many slots as the menu has room for dishes, and every
+ * slot has at least one dish, so the table is never more than half full and
+ * moving a dish to another key never needs to grow it.
+ *
+ * Dishes that share a name share a chain, so the position of a given dish is
+ * kept in a table of its own, keyed by the dish, rather than searched for in
+ * its chain. It has as many slots as each index, and a slot whose dish is NULL
+ * is empty.
+ */
+typedef struct menu_slot_t {
+	unsigned int hash;
+	int head;
+} MenuSlot;
+
+typedef struct menu_index_t {
+	MenuSlot* slots;
+	int* next;
+	int* prev;
+	unsigned int* hashes;
+	bool byCook;
+} MenuIndex;
+
+typedef struct menu_position_t {
+	Dish dish;
+	int position;
+} MenuPosition;
+
+struct menu_t {
+	int size;
+	int capacity;
+	Dish* dishes;
+	MenuIndex names;
+	MenuIndex cooks;
+	MenuPosition* positions;
+};
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+/* 32 bit FNV-1a */
+static unsigned int hashKey(const char* key) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)key; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* The finalizer of MurmurHash3, as dish addresses share their low bits */
+static unsigned int hashDish(Dish dish) {
+	uint64_t hash = (uint64_t)(uintptr_t)dish;
+	hash ^= hash >> 33;
+	hash *= UINT64_C(0xff51afd7ed558ccd);
+	hash ^= hash >> 33;
+	return (unsigned int)hash;
+}
+
+static const char* positionKey(Menu menu, MenuIndex* index, int position) {
+	Dish dish = menu->dishes[position];
+	return index->byCook ? dish->cook : dish->name;
+}
+
+static int slotMask(Menu menu) {
+	return menu->capacity*2-1;
+}
+
+/*
+ * Returns the slot holding @key, or the empty slot where it would be
+ * inserted.
+ */
+static int findSlot(Menu menu, MenuIndex* index, const char* key,
+					unsigned int hash) {
+	int mask = slotMask(menu);
+	int slot = hash & mask;
+	while (index->slots[slot].head != NO_DISH) {
+		if (index->slots[slot].hash == hash &&
+				strcmp(positionKey(menu,index,index->slots[slot].head),
+						key) == 0) {
+			return slot;
+		}
+		slot = (slot+1) & mask;
+	}
+	return slot;
+}
+
+static bool isInProbeRange(int home, int empty, int slot) {
+	if (empty <= slot) {
+		return (home > empty && home <= slot);
+	}
+	return (home > empty || home <= slot);
+}
+
+static void removeSlot(Menu menu, MenuIndex* index, int slot) {
+	int mask = slotMask(menu);
+	int empty = slot;
+	index->slots[empty].head = NO_DISH;
+	for (int i = (empty+1) & mask; index->slots[i].head != NO_DISH;
+			i = (i+1) & mask) {
+		int home = index->slots[i].hash & mask;
+		if (isInProbeRange(home,empty,i)) {
+			continue;
+		}
+		index->slots[empty] = index->slots[i];
+		index->slots[i].head = NO_DISH;
+		empty = i;
+	}
+}
+
+/*
+ * Puts @position at the head of @key's chain. The position's dish doesn't
+ * have to have @key yet.
+ */
+static void linkPosition(Menu menu, MenuIndex* index, int position,
+						const char* key) {
+	unsigned int hash = hashKey(key);
+	int slot = findSlot(menu,index,key,hash);
+	int head = index->slots[slot].head;
+	index->hashes[position] = hash;
+	index->prev[position] = NO_DISH;
+	index->next[position] = head;
+	if (head != NO_DISH) {
+		index->prev[head] = position;
+	}
+	index->slots[slot].hash = hash;
+	index->slots[slot].head = position;
+}
+
+/* Takes @position out of the chain of @key, which is its dish's key. */
+static void unlinkPosition(Menu menu, MenuIndex* index, int position,
+						const char* key) {
+	int prev = index->prev[position];
+	int next = index->next[position];
+	if (next != NO_DISH) {
+		index->prev[next] = prev;
+	}
+	if (prev != NO_DISH) {
+		index->next[prev] = next;
+		return;
+	}
+	int slot = findSlot(menu,index,key,index->hashes[position]);
+	if (next != NO_DISH) {
+		index->slots[slot].head = next;
+	} else {
+		removeSlot(menu,index,slot);
+	}
+}
+
+/*
+ * Moves the links of the dish at @from to @to, before the dish itself is
+ * moved. @to must not be linked.
+ */
+static void movePosition(Menu menu, MenuIndex* index, int from, int to) {
+	int prev = index->prev[from];
+	int next = index->next[from];
+	index->prev[to] = prev;
+	index->next[to] = next;
+	index->hashes[to] = index->hashes[from];
+	if (next != NO_DISH) {
+		index->prev[next] = to;
+	}
+	if (prev != NO_DISH) {
+		index->next[prev] = to;
+		return;
+	}
+	int slot = findSlot(menu,index,positionKey(menu,index,from),
+						index->hashes[from]);
+	index->slots[slot].head = to;
+}
+
+/*
+ * Returns the position slot holding @dish, or the empty slot where it would
+ * be inserted.
+ */
+static int findDishSlot(MenuPosition* positions, int mask, Dish dish) {
+	int slot = hashDish(dish) & mask;
+	while (positions[slot].dish != NULL && positions[slot].dish != dish) {
+		slot = (slot+1) & mask;
+	}
+	return slot;
+}
+
+static void setPosition(Menu menu, Dish dish, int position) {
+	int slot = findDishSlot(menu->positions,slotMask(menu),dish);
+	menu->positions[slot].dish = dish;
+	menu->positions[slot].position = position;
+}
+
+static void removePosition(Menu menu, Dish dish) {
+	int mask = slotMask(menu);
+	int empty = findDishSlot(menu->positions,mask,dish);
+	menu->positions[empty].dish = NULL;
+	for (int i = (empty+1) & mask; menu->positions[i].dish != NULL;
+			i = (i+1) & mask) {
+		int home = hashDish(menu->positions[i].dish) & mask;
+		if (isInProbeRange(home,empty,i)) {
+			continue;
+		}
+		menu->positions[empty] = menu->positions[i];
+		menu->positions[i].dish = NULL;
+		empty = i;
+	}
+}
+
+static int findPosition(Menu menu, Dish dish) {
+	if (dish->renameOwner != menu) {
+		return NO_DISH;
+	}
+	int slot = findDishSlot(menu->positions,slotMask(menu),dish);
+	if (menu->positions[slot].dish == NULL) {
+		return NO_DISH;
+	}
+	return menu->positions[slot].position;
+}
+
+static int findDishes(Menu menu, MenuIndex* index, const char* key,
+					Dish* dishes, int length) {
+	int slot = findSlot(menu,index,key,hashKey(key));
+	int count = 0;
+	for (int position = index->slots[slot].head; position != NO_DISH;
+			position = index->next[position]) {
+		if (count < length) {
+			dishes[count] = menu->dishes[position];
+		}
+		count++;
+	}
+	return count;
+}
+
+static void menuDishRenamed(void* owner, Dish dish, const char* name) {
+	Menu menu = (Menu)owner;
+	int position = findPosition(menu,dish);
+	unlinkPosition(menu,&menu->names,position,dish->name);
+	linkPosition(menu,&menu->names,position,name);
+}
+
+static MenuSlot* allocateSlots(int count) {
+	MenuSlot* slots = (MenuSlot*)malloc(sizeof(MenuSlot)*count);
+	if (slots == NULL) {
+		return NULL;
+	}
+	for (int i=0;i<count;i++) {
+		slots[i].head = NO_DISH;
+	}
+	return slots;
+}
+
+/*
+ * Places the slots of @index in @slots, a table of @count empty slots. Keys
+ * are distinct, so each slot goes to the first empty one of its probe run.
+ */
+static void rehashSlots(Menu menu, MenuIndex* index, MenuSlot* slots,
+						int count) {
+	int mask = count-1;
+	for (int i=0;index->slots != NULL && i<menu->capacity*2;i++) {
+		if (index->slots[i].head == NO_DISH) {
+			continue;
+		}
+		int slot = index->slots[i].hash & mask;
+		while (slots[slot].head != NO_DISH) {
+			slot = (slot+1) & mask;
+		}
+		slots[slot] = index->slots[i];
+	}
+	free(index->slots);
+	index->slots = slots;
+}
+
+static MenuPosition* allocatePositions(int count) {
+	size_t size = sizeof(MenuPosition)*count;
+	MenuPosition* positions = (MenuPosition*)malloc(size);
+	if (positions == NULL) {
+		return NULL;
+	}
+	for (int i=0;i<count;i++) {
+		positions[i].dish = NULL;
+	}
+	return positions;
+}
+
+/* Places the position of every dish in @positions, a table of @count slots */
+static void rehashPositions(Menu menu, MenuPosition* positions, int count) {
+	for (int i=0;i<menu->size;i++) {
+		int slot = findDishSlot(positions,count-1,menu->dishes[i]);
+		positions[slot].dish = menu->dishes[i];
+		positions[slot].position = i;
+	}
+	free(menu->positions);
+	menu->positions = positions;
+}
+
+static MenuResult growIndex(MenuIndex* index, int capacity) {
+	int* next = (int*)realloc(index->next,sizeof(int)*capacity);
+	if (next == NULL) {
+		return MENU_OUT_OF_MEMORY;
+	}
+	index->next = next;
+	int* prev = (int*)realloc(index->prev,sizeof(int)*capacity);
+	if (prev == NULL) {
+		return MENU_OUT_OF_MEMORY;
+	}
+	index->prev = prev;
+	unsigned int* hashes = (unsigned int*)realloc(index->hashes,
+											sizeof(unsigned int)*capacity);
+	if (hashes == NULL) {
+		return MENU_OUT_OF_MEMORY;
+	}
+	index->hashes = hashes;
+	return MENU_SUCCESS;
+}
+
+/*
+ * Grows every column to @capacity positions and rehashes both indexes and
+ * the dish positions into tables of 2*@capacity slots. On failure the menu
+ * keeps its old capacity.
+ */
+static MenuResult growMenu(Menu menu, int capacity) {
+	Dish* dishes = (Dish*)realloc(menu->dishes,sizeof(Dish)*capacity);
+	if (dishes == NULL) {
+		return MENU_OUT_OF_MEMORY;
+	}
+	menu->dishes = dishes;
+	if (growIndex(&menu->names,capacity) != MENU_SUCCESS ||
+			growIndex(&menu->cooks,capacity) != MENU_SUCCESS) {
+		return MENU_OUT_OF_MEMORY;
+	}
+	MenuSlot* nameSlots = allocateSlots(capacity*2);
+	MenuSlot* cookSlots = allocateSlots(capacity*2);
+	MenuPosition* positions = allocatePositions(capacity*2);
+	if (nameSlots == NULL || cookSlots == NULL || positions == NULL) {
+		free(nameSlots);
+		free(cookSlots);
+		free(positions);
+		return MENU_OUT_OF_MEMORY;
+	}
+	rehashSlots(menu,&menu->names,nameSlots,capacity*2);
+	rehashSlots(menu,&menu->cooks,cookSlots,capacity*2);
+	rehashPositions(menu,positions,capacity*2);
+	menu->capacity = capacity;
+	return MENU_SUCCESS;
+}
+
+static void initIndex(MenuIndex* index, bool byCook) {
+	index->slots = NULL;
+	index->next = NULL;
+	index->prev = NULL;
+	index->hashes = NULL;
+	index->byCook = byCook;
+}
+
+static void freeIndex(MenuIndex* index) {
+	free(index->slots);
+	free(index->next);
+	free(index->prev);
+	free(index->hashes);
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+Menu menuCreate(int expectedSize) {
+	int capacity = MENU_MIN_CAPACITY;
+	while (capacity < expectedSize && capacity < MENU_MAX_CAPACITY) {
+		capacity *= 2;
+	}
+	Menu menu = (Menu)malloc(sizeof(*menu));
+	if (menu == NULL) {
+		return NULL;
+	}
+	menu->size = 0;
+	menu->capacity = 0;
+	menu->dishes = NULL;
+	menu->positions = NULL;
+	initIndex(&menu->names,false);
+	initIndex(&menu->cooks,true);
+	if (growMenu(menu,capacity) != MENU_SUCCESS) {
+		menuDestroy(menu);
+		return NULL;
+	}
+	return menu;
+}
+
+void menuDestroy(Menu menu) {
+	if (menu == NULL) {
+		return;
+	}
+	for (int i=0;i<menu->size;i++) {
+		dishDestroy(menu->dishes[i]);
+	}
+	free(menu->dishes);
+	freeIndex(&menu->names);
+	freeIndex(&menu->cooks);
+	free(menu->positions);
+	free(menu);
+}
+
+MenuResult menuAddDish(Menu menu, Dish dish) {
+	CHECK_NULL_ARG(menu)
+	CHECK_NULL_ARG(dish)
+	if (dishSetRenameHook(dish,menuDishRenamed,menu) != DISH_SUCCESS) {
+		return MENU_DISH_ALREADY_OWNED;
+	}
+	if (menu->size == menu->capacity) {
+		if (menu->capacity >= MENU_MAX_CAPACITY ||
+				growMenu(menu,menu->capacity*2) != MENU_SUCCESS) {
+			dishSetRenameHook(dish,NULL,menu);
+			return MENU_OUT_OF_MEMORY;
+		}
+	}
+	int position = menu->size;
+	menu->dishes[position] = dish;
+	linkPosition(menu,&menu->names,position,dish->name);
+	linkPosition(menu,&menu->cooks,position,dish->cook);
+	setPosition(menu,dish,position);
+	menu->size++;
+	return MENU_SUCCESS;
+}
+
+MenuResult menuRemoveDish(Menu menu, Dish dish) {
+	CHECK_NULL_ARG(menu)
+	CHECK_NULL_ARG(dish)
+	int position = findPosition(menu,dish);
+	if (position == NO_DISH) {
+		return MENU_DISH_NOT_FOUND;
+	}
+	unlinkPosition(menu,&menu->names,position,dish->name);
+	unlinkPosition(menu,&menu->cooks,position,dish->cook);
+	removePosition(menu,dish);
+	int last = menu->size-1;
+	if (position != last) {
+		movePosition(menu,&menu->names,last,position);
+		movePosition(menu,&menu->cooks,last,position);
+		menu->dishes[position] = menu->dishes[last];
+		setPosition(menu,menu->dishes[position],position);
+	}
+	menu->size--;
+	dishSetRenameHook(dish,NULL,menu);
+	return MENU_SUCCESS;
+}
+
+int menuSize(Menu menu) {
+	if (menu == NULL) {
+		return 0;
+	}
+	return menu->size;
+}
+
+const Dish* menuGetDishes(Menu menu) {
+	if (menu == NULL) {
+		return NULL;
+	}
+	return menu->dishes;
+}
+
+int menuFindByName(Menu menu, const char* name, Dish* dishes, int length) {
+	if (menu == NULL || name == NULL) {
+		return 0;
+	}
+	return findDishes(menu,&menu->names,name,dishes,length);
+}
+
+int menuFindByCook(Menu menu, const char* cook, Dish* dishes, int length) {
+	if (menu == NULL || cook == NULL) {
+		return 0;
+	}
+	return findDishes(menu,&menu->cooks,cook,dishes,length);
+}
@@ -0,0 +1,139 @@
+/*
+ * menu.h
+ *
+ * A collection of dishes, indexed by dish name and by cook. The menu owns
+ * the dishes added to it, and finds the dishes with a given name or cook in
+ * O(1) expected time. Adding, removing and renaming a dish take O(1) expected
+ * time as well, however many dishes share its name. The name index follows
+ * dishSetName, so dishes may be renamed while they are in the menu.
+ *
+ * The menu's dishes are kept in one contiguous array, which menuGetDishes
+ * returns for iteration. Removing a dish moves the last dish into its place,
+ * so the order of the array isn't stable. The array only holds the Dish
+ * handles: each dish is still allocated on its own by dishCreate, so reading
+ * the dishes while iterating dereferences one separate allocation per dish.
+ * Allocating the dishes from a pool owned by the menu isn't done.
+ *
+ * A dish's rename hook (see dishSetRenameHook) is reserved by the menu for
+ * as long as the dish is in it.
+ *
+ * A menu isn't safe to use from several threads at once.
+ */
+
+#ifndef MENU_H_
+#define MENU_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "dish.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Menu Struct
+ ******************************************************************************/
+typedef struct menu_t* Menu;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	MENU_SUCCESS,				/* Operation succeeded 						  */
+	MENU_NULL_ARGUMENT,			/* A NULL argument was passed 				  */
+	MENU_DISH_NOT_FOUND,		/* The dish isn't in the menu				  */
+	MENU_DISH_ALREADY_OWNED,	/* The dish already belongs to a menu, or
+								   something else watches its renames		  */
+	MENU_OUT_OF_MEMORY			/* A memory error occured					  */
+} MenuResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a new empty menu.
+ * The menu starts with room for at least @expectedSize dishes, and grows as
+ * needed after that.
+ *
+ * @param expectedSize The number of dishes the menu is expected to hold.
+ * @return The new menu, or NULL if any error occured.
+ */
+Menu menuCreate(int expectedSize);
+
+/*
+ * Destroy a given menu and every dish in it, deallocating all necessary
+ * memory.
+ *
+ * @param menu The menu to destroy.
+ */
+void menuDestroy(Menu menu);
+
+/*
+ * Add a dish to the menu, which takes ownership of it. The dish must not be
+ * destroyed by the caller while it is in the menu; menuRemoveDish gives it
+ * back.
+ * The menu watches the dish's renames through dishSetRenameHook, so a dish
+ * that already has a rename hook is rejected with MENU_DISH_ALREADY_OWNED.
+ * Until the dish is removed its hook belongs to the menu, and
+ * dishSetRenameHook refuses to replace or remove it for anyone else.
+ *
+ * @param menu The menu to add to.
+ * @param dish The dish to add.
+ * @return Success or error code.
+ */
+MenuResult menuAddDish(Menu menu, Dish dish);
+
+/*
+ * Remove a dish from the menu, giving its ownership back to the caller.
+ *
+ * @param menu The menu to remove from.
+ * @param dish The dish to remove.
+ * @return Success or error code.
+ */
+MenuResult menuRemoveDish(Menu menu, Dish dish);
+
+/*
+ * Returns the number of dishes in the menu, or 0 if @menu is NULL.
+ *
+ * @param menu The menu to query.
+ * @return The number of dishes.
+ */
+int menuSize(Menu menu);
+
+/*
+ * Returns the menu's dishes as an array of menuSize dishes, or NULL if @menu
+ * is NULL. The array belongs to the menu, and is only valid until the next
+ * menuAddDish, menuRemoveDish or menuDestroy.
+ *
+ * @param menu The menu to read.
+ * @return The menu's dishes.
+ */
+const Dish* menuGetDishes(Menu menu);
+
+/*
+ * Find the dishes with a given name.
+ * Up to @length of them are placed in @dishes, in no particular order, and
+ * the number of dishes with that name is returned. Passing a @length of 0
+ * only counts them, in which case @dishes may be NULL.
+ * Returns 0 if @menu or @name is NULL.
+ *
+ * @param menu The menu to search.
+ * @param name The dish name to look for.
+ * @param dishes An array with room for @length dishes.
+ * @param length The number of dishes @dishes can hold.
+ * @return The number of dishes with that name.
+ */
+int menuFindByName(Menu menu, const char* name, Dish* dishes, int length);
+
+/*
+ * Find the dishes of a given cook, as menuFindByName finds dishes by name.
+ *
+ * @param menu The menu to search.
+ * @param cook The cook to look for.
+ * @param dishes An array with room for @length dishes.
+ * @param length The number of dishes @dishes can hold.
+ * @return The number of dishes of that cook.
+ */
+int menuFindByCook(Menu menu, const char* cook, Dish* dishes, int length);
+
+#endif /* MENU_H_ */
@@ -0,0 +1,228 @@
+#include "menu.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, MENU_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) ASSERT_EQUALS(expr, MENU_NULL_ARGUMENT)
+#define ASSERT_NOT_FOUND(expr) ASSERT_EQUALS(expr, MENU_DISH_NOT_FOUND)
+
+#define TEST_DISHES 5000
+#define TEST_COOKS 7
+
+static Dish makeDish(int i) {
+	char name[32];
+	char cook[32];
+	sprintf(name, "Dish %d", i);
+	sprintf(cook, "Cook %d", i % TEST_COOKS);
+	return dishCreate(name, cook, 4);
+}
+
+static bool isFound(Dish dish, const Dish* dishes, int count) {
+	for (int i = 0; i < count; i++) {
+		if (dishes[i] == dish) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void ignoreRename(void* owner, Dish dish, const char* name) {
+	(void)owner;
+	(void)dish;
+	(void)name;
+}
+
+static bool testAddAndFind() {
+	Menu menu = menuCreate(0);
+	ASSERT_NOT_EQUALS(menu, NULL);
+	Dish soup = dishCreate("Soup", "Alice", 3);
+	Dish stew = dishCreate("Stew", "Alice", 3);
+	Dish soup2 = dishCreate("Soup", "Bob", 3);
+
+	ASSERT_NULL_ARGUMENT(menuAddDish(NULL, soup));
+	ASSERT_NULL_ARGUMENT(menuAddDish(menu, NULL));
+	ASSERT_SUCCESS(menuAddDish(menu, soup));
+	ASSERT_SUCCESS(menuAddDish(menu, stew));
+	ASSERT_SUCCESS(menuAddDish(menu, soup2));
+	ASSERT_EQUALS(menuAddDish(menu, soup), MENU_DISH_ALREADY_OWNED);
+	/* the rename hook stays the menu's while the dish is in it */
+	ASSERT_EQUALS(dishSetRenameHook(soup, ignoreRename, NULL),
+				DISH_RENAME_HOOK_IN_USE);
+	ASSERT_EQUALS(dishSetRenameHook(soup, NULL, NULL), DISH_RENAME_HOOK_IN_USE);
+	Menu other = menuCreate(0);
+	ASSERT_EQUALS(menuAddDish(other, soup), MENU_DISH_ALREADY_OWNED);
+	menuDestroy(other);
+	ASSERT_EQUALS(menuSize(menu), 3);
+	ASSERT_EQUALS(menuSize(NULL), 0);
+
+	Dish found[3];
+	ASSERT_EQUALS(menuFindByName(menu, "Soup", found, 3), 2);
+	ASSERT(isFound(soup, found, 2) && isFound(soup2, found, 2));
+	ASSERT_EQUALS(menuFindByName(menu, "Soup", found, 1), 2);
+	ASSERT_EQUALS(menuFindByName(menu, "Stew", NULL, 0), 1);
+	ASSERT_EQUALS(menuFindByName(menu, "Salad", found, 3), 0);
+	ASSERT_EQUALS(menuFindByName(menu, NULL, found, 3), 0);
+	ASSERT_EQUALS(menuFindByCook(menu, "Alice", found, 3), 2);
+	ASSERT(isFound(soup, found, 2) && isFound(stew, found, 2));
+	ASSERT_EQUALS(menuFindByCook(menu, "Bob", found, 3), 1);
+	ASSERT_EQUALS(found[0], soup2);
+
+	const Dish* dishes = menuGetDishes(menu);
+	for (int i = 0; i < menuSize(menu); i++) {
+		ASSERT(dishes[i] == soup || dishes[i] == stew || dishes[i] == soup2);
+	}
+	ASSERT_EQUALS(menuGetDishes(NULL), NULL);
+
+	menuDestroy(menu);
+	menuDestroy(NULL);
+	return true;
+}
+
+static bool testRename() {
+	Menu menu = menuCreate(4);
+	Dish soup = dishCreate("Soup", "Alice", 3);
+	Dish stew = dishCreate("Stew", "Alice", 3);
+	ASSERT_SUCCESS(menuAddDish(menu, soup));
+	ASSERT_SUCCESS(menuAddDish(menu, stew));
+
+	Dish found[2];
+	ASSERT_EQUALS(dishSetName(soup, "Broth"), DISH_SUCCESS);
+	ASSERT_EQUALS(menuFindByName(menu, "Soup", found, 2), 0);
+	ASSERT_EQUALS(menuFindByName(menu, "Broth", found, 2), 1);
+	ASSERT_EQUALS(found[0], soup);
+
+	ASSERT_EQUALS(dishSetName(soup, "A much longer name for the same soup"),
+				DISH_SUCCESS);
+	ASSERT_EQUALS(menuFindByName(menu, "Broth", found, 2), 0);
+	ASSERT_EQUALS(menuFindByName(menu, "A much longer name for the same soup",
+								found, 2), 1);
+
+	ASSERT_EQUALS(dishSetName(stew, "A much longer name for the same soup"),
+				DISH_SUCCESS);
+	ASSERT_EQUALS(menuFindByName(menu, "A much longer name for the same soup",
+								found, 2), 2);
+	ASSERT_EQUALS(menuFindByName(menu, "Stew", found, 2), 0);
+	ASSERT_EQUALS(menuFindByCook(menu, "Alice", found, 2), 2);
+
+	Dish clone = dishClone(soup);
+	ASSERT_EQUALS(dishSetName(clone, "Clone"), DISH_SUCCESS);
+	ASSERT_EQUALS(menuFindByName(menu, "Clone", found, 2), 0);
+	ASSERT_SUCCESS(menuAddDish(menu, clone));
+	ASSERT_EQUALS(menuFindByName(menu, "Clone", found, 2), 1);
+
+	menuDestroy(menu);
+	return true;
+}
+
+static bool testRemove() {
+	Menu menu = menuCreate(0);
+	Dish dishes[TEST_DISHES];
+	for (int i = 0; i < TEST_DISHES; i++) {
+		dishes[i] = makeDish(i);
+		ASSERT_SUCCESS(menuAddDish(menu, dishes[i]));
+	}
+	Dish outsider = makeDish(0);
+	ASSERT_NULL_ARGUMENT(menuRemoveDish(menu, NULL));
+	ASSERT_NOT_FOUND(menuRemoveDish(menu, outsider));
+	dishDestroy(outsider);
+
+	for (int i = 0; i < TEST_DISHES; i += 2) {
+		ASSERT_SUCCESS(menuRemoveDish(menu, dishes[i]));
+		ASSERT_NOT_FOUND(menuRemoveDish(menu, dishes[i]));
+	}
+	ASSERT_EQUALS(menuSize(menu), TEST_DISHES / 2);
+	/* a removed dish's hook is free again */
+	ASSERT_EQUALS(dishSetRenameHook(dishes[0], ignoreRename, NULL),
+				DISH_SUCCESS);
+	ASSERT_EQUALS(dishSetRenameHook(dishes[0], NULL, NULL), DISH_SUCCESS);
+
+	static Dish found[TEST_DISHES];
+	int total = 0;
+	for (int c = 0; c < TEST_COOKS; c++) {
+		char cook[32];
+		sprintf(cook, "Cook %d", c);
+		total += menuFindByCook(menu, cook, found, TEST_DISHES);
+	}
+	ASSERT_EQUALS(total, TEST_DISHES / 2);
+	for (int i = 0; i < TEST_DISHES; i++) {
+		char name[32];
+		sprintf(name, "Dish %d", i);
+		ASSERT_EQUALS(menuFindByName(menu, name, found, 1), i % 2);
+		if (i % 2 == 1) {
+			ASSERT_EQUALS(found[0], dishes[i]);
+		}
+	}
+
+	for (int i = 0; i < TEST_DISHES; i += 2) {
+		ASSERT_EQUALS(dishSetName(dishes[i], "Renamed"), DISH_SUCCESS);
+		ASSERT_SUCCESS(menuAddDish(menu, dishes[i]));
+	}
+	ASSERT_EQUALS(menuFindByName(menu, "Renamed", NULL, 0), TEST_DISHES / 2);
+
+	menuDestroy(menu);
+	return true;
+}
+
+static bool testRemoveClones() {
+	Menu menu = menuCreate(0);
+	static Dish clones[TEST_DISHES];
+	clones[0] = dishCreate("Clone", "Cook", 4);
+	ASSERT_SUCCESS(menuAddDish(menu, clones[0]));
+	for (int i = 1; i < TEST_DISHES; i++) {
+		clones[i] = dishClone(clones[0]);
+		ASSERT_SUCCESS(menuAddDish(menu, clones[i]));
+	}
+	ASSERT_EQUALS(menuFindByName(menu, "Clone", NULL, 0), TEST_DISHES);
+
+	for (int i = 0; i < TEST_DISHES; i += 2) {
+		ASSERT_SUCCESS(menuRemoveDish(menu, clones[i]));
+		ASSERT_NOT_FOUND(menuRemoveDish(menu, clones[i]));
+	}
+	ASSERT_EQUALS(menuFindByName(menu, "Clone", NULL, 0), TEST_DISHES / 2);
+	const Dish* dishes = menuGetDishes(menu);
+	for (int i = 0; i < menuSize(menu); i++) {
+		ASSERT(isFound(dishes[i], clones, TEST_DISHES));
+	}
+	for (int i = 1; i < TEST_DISHES; i += 2) {
+		ASSERT_EQUALS(dishSetName(clones[i], "Renamed"), DISH_SUCCESS);
+	}
+	ASSERT_EQUALS(menuFindByName(menu, "Renamed", NULL, 0), TEST_DISHES / 2);
+	for (int i = TEST_DISHES - 1; i > 0; i -= 2) {
+		ASSERT_SUCCESS(menuRemoveDish(menu, clones[i]));
+	}
+	ASSERT_EQUALS(menuSize(menu), 0);
+	ASSERT_EQUALS(menuFindByName(menu, "Renamed", NULL, 0), 0);
+
+	for (int i = 0; i < TEST_DISHES; i++) {
+		dishDestroy(clones[i]);
+	}
+	menuDestroy(menu);
+	return true;
+}
+
+int main() {
+	RUN_TEST(testAddAndFind);
+	RUN_TEST(testRename);
+	RUN_TEST(testRemove);
+	RUN_TEST(testRemoveClones);
+	return 0;
+}
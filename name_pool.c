@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "name_pool.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return NAME_POOL_NULL_ARGUMENT;	}
+
+#define NAME_POOL_MIN_CAPACITY 64
+
+/*
+ * Names are kept in an array indexed by id, each in its own allocation so
+ * resolved strings never move. The slots array is an open addressing hash
+ * table with linear probing from name hashes to id+1, where 0 marks an empty
+ * slot. Names are never removed one by one, so there are no tombstones.
+ * generation counts the calls to namePoolClear, and is stamped on every
+ * handle so that ids reused after a clear don't resolve old handles.
+ */
+static struct {
+	char** names;
+	unsigned int* hashes;
+	int size;
+	int namesCapacity;
+	int* slots;
+	int slotsCapacity;
+	unsigned int generation;
+} pool = { NULL, NULL, 0, 0, NULL, 0, 0 };
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+/* 32 bit FNV-1a */
+static unsigned int hashName(const char* name) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static bool isCurrent(PooledName pooled) {
+	return pooled.generation == pool.generation &&
+			pooled.id < (unsigned int)pool.size;
+}
+
+/*
+ * Returns the slot holding @name, or the empty slot where it would be
+ * inserted.
+ */
+static int findSlot(const char* name, unsigned int hash) {
+	int mask = pool.slotsCapacity-1;
+	int slot = hash & mask;
+	while (pool.slots[slot] != 0) {
+		int id = pool.slots[slot]-1;
+		if (pool.hashes[id] == hash && strcmp(pool.names[id],name) == 0) {
+			return slot;
+		}
+		slot = (slot+1) & mask;
+	}
+	return slot;
+}
+
+static NamePoolResult growSlots(void) {
+	int capacity = pool.slotsCapacity == 0 ? NAME_POOL_MIN_CAPACITY :
+											pool.slotsCapacity*2;
+	int* slots = (int*)calloc(capacity,sizeof(int));
+	if (slots == NULL) {
+		return NAME_POOL_OUT_OF_MEMORY;
+	}
+	free(pool.slots);
+	pool.slots = slots;
+	pool.slotsCapacity = capacity;
+	int mask = capacity-1;
+	for (int id=0;id<pool.size;id++) {
+		int slot = pool.hashes[id] & mask;
+		while (pool.slots[slot] != 0) {
+			slot = (slot+1) & mask;
+		}
+		pool.slots[slot] = id+1;
+	}
+	return NAME_POOL_SUCCESS;
+}
+
+static NamePoolResult growNames(void) {
+	int capacity = pool.namesCapacity == 0 ? NAME_POOL_MIN_CAPACITY :
+											pool.namesCapacity*2;
+	char** names = (char**)realloc(pool.names,sizeof(char*)*capacity);
+	if (names == NULL) {
+		return NAME_POOL_OUT_OF_MEMORY;
+	}
+	pool.names = names;
+	unsigned int* hashes = (unsigned int*)realloc(pool.hashes,
+											sizeof(unsigned int)*capacity);
+	if (hashes == NULL) {
+		return NAME_POOL_OUT_OF_MEMORY;
+	}
+	pool.hashes = hashes;
+	pool.namesCapacity = capacity;
+	return NAME_POOL_SUCCESS;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+NamePoolResult namePoolIntern(const char* name, PooledName* pooled) {
+	CHECK_NULL_ARG(name)
+	CHECK_NULL_ARG(pooled)
+	if ((pool.size+1)*2 > pool.slotsCapacity &&
+			growSlots() != NAME_POOL_SUCCESS) {
+		return NAME_POOL_OUT_OF_MEMORY;
+	}
+	unsigned int hash = hashName(name);
+	int slot = findSlot(name,hash);
+	if (pool.slots[slot] == 0) {
+		if (pool.size == pool.namesCapacity &&
+				growNames() != NAME_POOL_SUCCESS) {
+			return NAME_POOL_OUT_OF_MEMORY;
+		}
+		char* copy = (char*)malloc(strlen(name)+1);
+		if (copy == NULL) {
+			return NAME_POOL_OUT_OF_MEMORY;
+		}
+		strcpy(copy,name);
+		pool.names[pool.size] = copy;
+		pool.hashes[pool.size] = hash;
+		pool.size++;
+		pool.slots[slot] = pool.size;
+	}
+	pooled->id = pool.slots[slot]-1;
+	pooled->hash = hash;
+	pooled->generation = pool.generation;
+	return NAME_POOL_SUCCESS;
+}
+
+const char* namePoolGet(PooledName pooled) {
+	if (!isCurrent(pooled)) {
+		return NULL;
+	}
+	return pool.names[pooled.id];
+}
+
+NamePoolResult namePoolFind(unsigned int id, PooledName* pooled) {
+	CHECK_NULL_ARG(pooled)
+	if (id >= (unsigned int)pool.size) {
+		return NAME_POOL_BAD_ID;
+	}
+	pooled->id = id;
+	pooled->hash = pool.hashes[id];
+	pooled->generation = pool.generation;
+	return NAME_POOL_SUCCESS;
+}
+
+bool namePoolAreEqual(PooledName pooled1, PooledName pooled2) {
+	return pooled1.id == pooled2.id &&
+			pooled1.generation == pooled2.generation;
+}
+
+int namePoolSize(void) {
+	return pool.size;
+}
+
+void namePoolClear(void) {
+	for (int id=0;id<pool.size;id++) {
+		free(pool.names[id]);
+	}
+	free(pool.names);
+	free(pool.hashes);
+	free(pool.slots);
+	pool.names = NULL;
+	pool.hashes = NULL;
+	pool.size = 0;
+	pool.namesCapacity = 0;
+	pool.slots = NULL;
+	pool.slotsCapacity = 0;
+	pool.generation++;
+}
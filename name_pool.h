@@ -0,0 +1,109 @@
+/*
+ * name_pool.h
+ *
+ * A global pool of interned names. Every distinct name is stored once, and
+ * callers hold a small handle to it instead of their own copy, so two handles
+ * name the same string iff their ids are equal.
+ *
+ * namePoolClear starts a new generation of the pool. Handles from an earlier
+ * generation stay safe to pass around, but resolve to nothing, so a cleared
+ * name can't be mistaken for a later name that reuses its id.
+ *
+ * The pool is shared by the whole program and is not safe to intern into from
+ * several threads at once.
+ */
+
+#ifndef NAME_POOL_H_
+#define NAME_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Pooled Name Struct
+ ******************************************************************************/
+/*
+ * A handle to an interned name. The hash of the name is computed once when it
+ * is interned and kept in the handle, so hash tables keyed by names don't
+ * have to hash the string again. generation is the pool's generation when
+ * the handle was given out.
+ */
+typedef struct pooled_name_t {
+	unsigned int id;
+	unsigned int hash;
+	unsigned int generation;
+} PooledName;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	NAME_POOL_SUCCESS,			/* Operation succeeded 						  */
+	NAME_POOL_NULL_ARGUMENT,	/* A NULL argument was passed 				  */
+	NAME_POOL_OUT_OF_MEMORY,	/* A memory error occured					  */
+	NAME_POOL_BAD_ID			/* No interned name has the passed id		  */
+} NamePoolResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Intern a name, placing its handle in @pooled.
+ * Interning a name that is already in the pool returns the existing handle.
+ *
+ * @param name The name to intern.
+ * @param pooled The name's handle will be placed here.
+ * @return Success or error code.
+ */
+NamePoolResult namePoolIntern(const char* name, PooledName* pooled);
+
+/*
+ * Returns the string a handle refers to. The string stays valid until
+ * namePoolClear is called.
+ * Returns NULL if the handle isn't one that namePoolIntern gave out since the
+ * pool was last cleared.
+ *
+ * @param pooled The handle to resolve.
+ * @return The interned name.
+ */
+const char* namePoolGet(PooledName pooled);
+
+/*
+ * Place in @pooled the handle of the name interned with the given id.
+ * Lets callers that only store ids, such as IngredientRecord, rebuild the
+ * full handle.
+ *
+ * @param id The id of an interned name.
+ * @param pooled The name's handle will be placed here.
+ * @return Success or error code.
+ */
+NamePoolResult namePoolFind(unsigned int id, PooledName* pooled);
+
+/*
+ * Returns true if both handles refer to the same name. Handles from different
+ * generations of the pool are never equal.
+ *
+ * @param pooled1 The first handle.
+ * @param pooled2 The second handle.
+ * @return Whether the names are equal.
+ */
+bool namePoolAreEqual(PooledName pooled1, PooledName pooled2);
+
+/*
+ * Returns the number of distinct names in the pool.
+ *
+ * @return The pool's size.
+ */
+int namePoolSize(void);
+
+/*
+ * Remove every name from the pool, deallocating all its memory, and start a
+ * new generation. Handles given out before the call no longer resolve:
+ * namePoolGet returns NULL for them.
+ */
+void namePoolClear(void);
+
+#endif /* NAME_POOL_H_ */
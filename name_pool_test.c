@@ -0,0 +1,106 @@
+#include "name_pool.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+#define ASSERT_TRUE(expr) ASSERT_EQUALS(expr, true)
+#define ASSERT_FALSE(expr) ASSERT_EQUALS(expr, false)
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, NAME_POOL_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) ASSERT_EQUALS(expr, NAME_POOL_NULL_ARGUMENT)
+
+static bool testIntern() {
+	PooledName tomato, tomato2, potato;
+	ASSERT_NULL_ARGUMENT(namePoolIntern(NULL, &tomato));
+	ASSERT_NULL_ARGUMENT(namePoolIntern("Tomato", NULL));
+
+	ASSERT_SUCCESS(namePoolIntern("Tomato", &tomato));
+	ASSERT_SUCCESS(namePoolIntern("Potato", &potato));
+	char name[] = "Tomato";
+	ASSERT_SUCCESS(namePoolIntern(name, &tomato2));
+	ASSERT_EQUALS(namePoolSize(), 2);
+	ASSERT_TRUE(namePoolAreEqual(tomato, tomato2));
+	ASSERT_FALSE(namePoolAreEqual(tomato, potato));
+	ASSERT_EQUALS(tomato.hash, tomato2.hash);
+
+	namePoolClear();
+	ASSERT_EQUALS(namePoolSize(), 0);
+	return true;
+}
+
+static bool testGet() {
+	PooledName tomato;
+	char name[] = "Tomato";
+	ASSERT_SUCCESS(namePoolIntern(name, &tomato));
+	name[0] = 'P';
+	ASSERT_EQUALS(strcmp(namePoolGet(tomato), "Tomato"), 0);
+
+	PooledName bad = { 1000, 0 };
+	ASSERT_EQUALS(namePoolGet(bad), NULL);
+
+	PooledName found;
+	ASSERT_NULL_ARGUMENT(namePoolFind(tomato.id, NULL));
+	ASSERT_EQUALS(namePoolFind(bad.id, &found), NAME_POOL_BAD_ID);
+	ASSERT_SUCCESS(namePoolFind(tomato.id, &found));
+	ASSERT_EQUALS(found.id, tomato.id);
+	ASSERT_EQUALS(found.hash, tomato.hash);
+
+	namePoolClear();
+	ASSERT_EQUALS(namePoolGet(tomato), NULL);
+
+	PooledName potato;
+	ASSERT_SUCCESS(namePoolIntern("Potato", &potato));
+	ASSERT_EQUALS(potato.id, tomato.id);
+	ASSERT_EQUALS(namePoolGet(tomato), NULL);
+	ASSERT_FALSE(namePoolAreEqual(tomato, potato));
+	ASSERT_SUCCESS(namePoolFind(potato.id, &found));
+	ASSERT_TRUE(namePoolAreEqual(found, potato));
+
+	namePoolClear();
+	return true;
+}
+
+static bool testManyNames() {
+	const int count = 10000;
+	PooledName first, again;
+	char name[32];
+	for (int i=0;i<count;i++) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_SUCCESS(namePoolIntern(name, &first));
+	}
+	ASSERT_EQUALS(namePoolSize(), count);
+	for (int i=0;i<count;i++) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_SUCCESS(namePoolIntern(name, &again));
+		ASSERT_EQUALS(again.id, (unsigned int)i);
+		ASSERT_EQUALS(strcmp(namePoolGet(again), name), 0);
+	}
+	ASSERT_EQUALS(namePoolSize(), count);
+
+	namePoolClear();
+	return true;
+}
+
+int main() {
+	RUN_TEST(testIntern);
+	RUN_TEST(testGet);
+	RUN_TEST(testManyNames);
+	return 0;
+}
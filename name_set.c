@@ -0,0 +1,220 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "name_set.h"
+
+#define CHECK_NULL_ARG(val) \
+	if (val == NULL) {	return NAME_SET_NULL_ARGUMENT;	}
+
+#define NAME_SET_MIN_CAPACITY 8
+#define NAME_SET_MAX_CAPACITY (1 << 30)
+
+/*
+ * The set is an open addressing hash table with linear probing. A slot with
+ * count 0 is empty. Removal shifts the following entries of the probe run
+ * back, so lookups never have to skip over tombstones.
+ */
+typedef struct name_entry_t {
+	unsigned int hash;
+	int count;
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+} NameEntry;
+
+struct name_set_t {
+	NameEntry* entries;
+	int capacity;
+	int size;
+	int duplicates;
+};
+
+/******************************************************************************
+ * static internal functions
+ *****************************************************************************/
+/* 32 bit FNV-1a */
+static unsigned int hashName(const char* name) {
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static NameEntry* allocateEntries(int capacity) {
+	NameEntry* entries = (NameEntry*)malloc(sizeof(NameEntry)*capacity);
+	if (entries == NULL) {
+		return NULL;
+	}
+	for (int i=0;i<capacity;i++) {
+		entries[i].count = 0;
+	}
+	return entries;
+}
+
+/*
+ * Returns the slot holding @name, or the empty slot where it would be
+ * inserted.
+ */
+static int findSlot(NameSet set, const char* name, unsigned int hash) {
+	int mask = set->capacity-1;
+	int slot = hash & mask;
+	while (set->entries[slot].count != 0) {
+		if (set->entries[slot].hash == hash &&
+				strcmp(set->entries[slot].name,name) == 0) {
+			return slot;
+		}
+		slot = (slot+1) & mask;
+	}
+	return slot;
+}
+
+static NameSetResult growSet(NameSet set) {
+	int capacity = set->capacity*2;
+	NameEntry* entries = allocateEntries(capacity);
+	if (entries == NULL) {
+		return NAME_SET_OUT_OF_MEMORY;
+	}
+	NameEntry* oldEntries = set->entries;
+	int oldCapacity = set->capacity;
+	set->entries = entries;
+	set->capacity = capacity;
+	for (int i=0;i<oldCapacity;i++) {
+		if (oldEntries[i].count != 0) {
+			int slot = findSlot(set,oldEntries[i].name,oldEntries[i].hash);
+			set->entries[slot] = oldEntries[i];
+		}
+	}
+	free(oldEntries);
+	return NAME_SET_SUCCESS;
+}
+
+static bool isInProbeRange(int home, int empty, int slot) {
+	if (empty <= slot) {
+		return (home > empty && home <= slot);
+	}
+	return (home > empty || home <= slot);
+}
+
+static void removeSlot(NameSet set, int slot) {
+	int mask = set->capacity-1;
+	int empty = slot;
+	set->entries[empty].count = 0;
+	for (int i = (empty+1) & mask; set->entries[i].count != 0; i = (i+1) & mask) {
+		int home = set->entries[i].hash & mask;
+		if (isInProbeRange(home,empty,i)) {
+			continue;
+		}
+		set->entries[empty] = set->entries[i];
+		set->entries[i].count = 0;
+		empty = i;
+	}
+	set->size--;
+}
+
+/******************************************************************************
+ * interface functions
+ *****************************************************************************/
+
+NameSet nameSetCreate(int expectedSize) {
+	int capacity = NAME_SET_MIN_CAPACITY;
+	while (capacity/2 < expectedSize && capacity < NAME_SET_MAX_CAPACITY) {
+		capacity *= 2;
+	}
+	NameSet set = (NameSet)malloc(sizeof(*set));
+	if (set == NULL) {
+		return NULL;
+	}
+	set->entries = allocateEntries(capacity);
+	if (set->entries == NULL) {
+		free(set);
+		return NULL;
+	}
+	set->capacity = capacity;
+	set->size = 0;
+	set->duplicates = 0;
+	return set;
+}
+
+NameSet nameSetCopy(NameSet set) {
+	if (set == NULL) {
+		return NULL;
+	}
+	NameSet copy = (NameSet)malloc(sizeof(*copy));
+	if (copy == NULL) {
+		return NULL;
+	}
+	copy->entries = (NameEntry*)malloc(sizeof(NameEntry)*set->capacity);
+	if (copy->entries == NULL) {
+		free(copy);
+		return NULL;
+	}
+	memcpy(copy->entries,set->entries,sizeof(NameEntry)*set->capacity);
+	copy->capacity = set->capacity;
+	copy->size = set->size;
+	copy->duplicates = set->duplicates;
+	return copy;
+}
+
+void nameSetDestroy(NameSet set) {
+	if (set == NULL) {
+		return;
+	}
+	free(set->entries);
+	free(set);
+}
+
+NameSetResult nameSetAdd(NameSet set, const char* name) {
+	CHECK_NULL_ARG(set)
+	CHECK_NULL_ARG(name)
+	if (strlen(name) > INGREDIENT_MAX_NAME_LENGTH) {
+		return NAME_SET_BAD_NAME;
+	}
+	unsigned int hash = hashName(name);
+	int slot = findSlot(set,name,hash);
+	if (set->entries[slot].count != 0) {
+		set->entries[slot].count++;
+		set->duplicates++;
+		return NAME_SET_SUCCESS;
+	}
+	if ((set->size+1)*2 > set->capacity) {
+		if (growSet(set) != NAME_SET_SUCCESS) {
+			return NAME_SET_OUT_OF_MEMORY;
+		}
+		slot = findSlot(set,name,hash);
+	}
+	set->entries[slot].hash = hash;
+	set->entries[slot].count = 1;
+	strcpy(set->entries[slot].name,name);
+	set->size++;
+	return NAME_SET_SUCCESS;
+}
+
+NameSetResult nameSetRemove(NameSet set, const char* name) {
+	CHECK_NULL_ARG(set)
+	CHECK_NULL_ARG(name)
+	int slot = findSlot(set,name,hashName(name));
+	if (set->entries[slot].count == 0) {
+		return NAME_SET_NAME_NOT_FOUND;
+	}
+	if (set->entries[slot].count > 1) {
+		set->entries[slot].count--;
+		set->duplicates--;
+		return NAME_SET_SUCCESS;
+	}
+	removeSlot(set,slot);
+	return NAME_SET_SUCCESS;
+}
+
+int nameSetCount(NameSet set, const char* name) {
+	if (set == NULL || name == NULL) {
+		return 0;
+	}
+	return set->entries[findSlot(set,name,hashName(name))].count;
+}
+
+int nameSetDuplicates(NameSet set) {
+	if (set == NULL) {
+		return 0;
+	}
+	return set->duplicates;
+}
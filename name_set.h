@@ -0,0 +1,105 @@
+/*
+ * name_set.h
+ *
+ * A hashed multiset of ingredient names, used by dishes to answer duplicate
+ * queries without comparing every pair of ingredients.
+ */
+
+#ifndef NAME_SET_H_
+#define NAME_SET_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "ingredient.h"
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Name Set Struct
+ ******************************************************************************/
+typedef struct name_set_t* NameSet;
+
+/*******************************************************************************
+ * Return Value Definition
+ ******************************************************************************/
+typedef enum {
+	NAME_SET_SUCCESS,			/* Operation succeeded 						  */
+	NAME_SET_NULL_ARGUMENT,		/* A NULL argument was passed 				  */
+	NAME_SET_BAD_NAME,			/* An invalid name was passed				  */
+	NAME_SET_NAME_NOT_FOUND,	/* The requested name isn't in the set		  */
+	NAME_SET_OUT_OF_MEMORY		/* A memory error occured					  */
+} NameSetResult;
+
+/*******************************************************************************
+ * Functions Declarations
+ ******************************************************************************/
+/*
+ * Create a new empty name set.
+ * The set starts with room for at least @expectedSize distinct names without
+ * rehashing, and grows as needed after that.
+ *
+ * @param expectedSize The number of names the set is expected to hold.
+ * @return The new set, or NULL if any error occured.
+ */
+NameSet nameSetCreate(int expectedSize);
+
+/*
+ * Create a copy of a name set, holding the same names with the same counts.
+ *
+ * @param set The set to copy.
+ * @return The new set, or NULL if any error occured.
+ */
+NameSet nameSetCopy(NameSet set);
+
+/*
+ * Destroy a given name set, deallocating all necessary memory.
+ *
+ * @param set The set to destroy.
+ */
+void nameSetDestroy(NameSet set);
+
+/*
+ * Add an occurrence of a name to the set.
+ * A name may be added several times; every occurrence after the first one
+ * counts as a duplicate.
+ *
+ * Names longer than INGREDIENT_MAX_NAME_LENGTH are rejected with
+ * NAME_SET_BAD_NAME.
+ *
+ * @param set The set to add to.
+ * @param name The name to add.
+ * @return Success or error code.
+ */
+NameSetResult nameSetAdd(NameSet set, const char* name);
+
+/*
+ * Remove one occurrence of a name from the set.
+ *
+ * @param set The set to remove from.
+ * @param name The name to remove.
+ * @return Success or error code.
+ */
+NameSetResult nameSetRemove(NameSet set, const char* name);
+
+/*
+ * Returns how many times a name was added and not yet removed.
+ * Returns 0 if @set or @name is NULL.
+ *
+ * @param set The set to search.
+ * @param name The name to count.
+ * @return The name's number of occurrences.
+ */
+int nameSetCount(NameSet set, const char* name);
+
+/*
+ * Returns the number of occurrences in the set beyond the first occurrence
+ * of each name. The set holds a duplicate name iff this is positive.
+ * Returns 0 if @set is NULL.
+ *
+ * @param set The set to test.
+ * @return The number of duplicate occurrences.
+ */
+int nameSetDuplicates(NameSet set);
+
+#endif /* NAME_SET_H_ */
@@ -0,0 +1,133 @@
+#include "name_set.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(expr) do { \
+	if(!(expr)) { \
+		printf("\nAssertion failed %s (%s:%d).\n", #expr, __FILE__, __LINE__); \
+		return false; \
+	} else { \
+		printf("."); \
+	} \
+} while (0)
+
+#define RUN_TEST(test) do { \
+  printf("Running "#test); \
+  if(test()) { \
+    printf("[OK]\n"); \
+  } \
+} while(0)
+
+#define ASSERT_EQUALS(expr,expected) ASSERT((expr) == (expected))
+#define ASSERT_NOT_EQUALS(expr,unexpected) ASSERT((expr) != (unexpected))
+
+#define ASSERT_SUCCESS(expr) ASSERT_EQUALS(expr, NAME_SET_SUCCESS)
+#define ASSERT_NULL_ARGUMENT(expr) ASSERT_EQUALS(expr, NAME_SET_NULL_ARGUMENT)
+#define ASSERT_NOT_FOUND(expr) ASSERT_EQUALS(expr, NAME_SET_NAME_NOT_FOUND)
+
+static bool testCreate() {
+	NameSet set = nameSetCreate(0);
+	ASSERT_NOT_EQUALS(set, NULL);
+	ASSERT_EQUALS(nameSetDuplicates(set), 0);
+	nameSetDestroy(set);
+
+	set = nameSetCreate(1000);
+	ASSERT_NOT_EQUALS(set, NULL);
+	nameSetDestroy(set);
+	nameSetDestroy(NULL);
+
+	return true;
+}
+
+static bool testAdd() {
+	NameSet set = nameSetCreate(0);
+
+	ASSERT_NULL_ARGUMENT(nameSetAdd(NULL, "Tomato"));
+	ASSERT_NULL_ARGUMENT(nameSetAdd(set, NULL));
+	ASSERT_EQUALS(nameSetAdd(set,
+		"A name that is much longer than forty characters"), NAME_SET_BAD_NAME);
+
+	ASSERT_SUCCESS(nameSetAdd(set, "Tomato"));
+	ASSERT_SUCCESS(nameSetAdd(set, "Cucumber"));
+	ASSERT_EQUALS(nameSetDuplicates(set), 0);
+	ASSERT_SUCCESS(nameSetAdd(set, "Tomato"));
+	ASSERT_EQUALS(nameSetDuplicates(set), 1);
+	ASSERT_EQUALS(nameSetCount(set, "Tomato"), 2);
+	ASSERT_EQUALS(nameSetCount(set, "Cucumber"), 1);
+	ASSERT_EQUALS(nameSetCount(set, "Onion"), 0);
+
+	nameSetDestroy(set);
+	return true;
+}
+
+static bool testRemove() {
+	NameSet set = nameSetCreate(0);
+
+	ASSERT_NULL_ARGUMENT(nameSetRemove(NULL, "Tomato"));
+	ASSERT_NULL_ARGUMENT(nameSetRemove(set, NULL));
+	ASSERT_NOT_FOUND(nameSetRemove(set, "Tomato"));
+
+	nameSetAdd(set, "Tomato");
+	nameSetAdd(set, "Tomato");
+	ASSERT_SUCCESS(nameSetRemove(set, "Tomato"));
+	ASSERT_EQUALS(nameSetDuplicates(set), 0);
+	ASSERT_EQUALS(nameSetCount(set, "Tomato"), 1);
+	ASSERT_SUCCESS(nameSetRemove(set, "Tomato"));
+	ASSERT_NOT_FOUND(nameSetRemove(set, "Tomato"));
+
+	nameSetDestroy(set);
+	return true;
+}
+
+static bool testCopy() {
+	NameSet set = nameSetCreate(0);
+	nameSetAdd(set, "Tomato");
+	nameSetAdd(set, "Tomato");
+
+	NameSet copy = nameSetCopy(set);
+	ASSERT_NOT_EQUALS(copy, NULL);
+	ASSERT_EQUALS(nameSetDuplicates(copy), 1);
+	ASSERT_SUCCESS(nameSetRemove(set, "Tomato"));
+	ASSERT_EQUALS(nameSetCount(copy, "Tomato"), 2);
+	ASSERT_EQUALS(nameSetCopy(NULL), NULL);
+
+	nameSetDestroy(set);
+	nameSetDestroy(copy);
+	return true;
+}
+
+static bool testManyNames() {
+	NameSet set = nameSetCreate(0);
+	char name[INGREDIENT_MAX_NAME_LENGTH + 1];
+
+	for (int i = 0; i < 5000; i++) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_EQUALS(nameSetAdd(set, name), NAME_SET_SUCCESS);
+	}
+	ASSERT_EQUALS(nameSetDuplicates(set), 0);
+	for (int i = 0; i < 5000; i += 2) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_EQUALS(nameSetRemove(set, name), NAME_SET_SUCCESS);
+	}
+	for (int i = 0; i < 5000; i++) {
+		sprintf(name, "Ingredient %d", i);
+		ASSERT_EQUALS(nameSetCount(set, name), i % 2);
+	}
+	sprintf(name, "Ingredient %d", 4999);
+	ASSERT_SUCCESS(nameSetAdd(set, name));
+	ASSERT_EQUALS(nameSetDuplicates(set), 1);
+
+	nameSetDestroy(set);
+	return true;
+}
+
+int main() {
+
+	RUN_TEST(testCreate);
+	RUN_TEST(testAdd);
+	RUN_TEST(testRemove);
+	RUN_TEST(testCopy);
+	RUN_TEST(testManyNames);
+
+	return 0;
+}